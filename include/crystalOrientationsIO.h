@@ -9,6 +9,7 @@ template <int dim>
 class crystalOrientationsIO{
 public:
   crystalOrientationsIO();
+  ~crystalOrientationsIO();
   void loadOrientations(std::string _voxelFileName,
 			unsigned int headerLines,
 			std::string _orientationFileName,
@@ -16,8 +17,25 @@ public:
 			std::vector<double> _span);
   void loadOrientationVector(std::string _eulerFileName, bool _enableMultiphase, unsigned int _numVoxelData);
   unsigned int getMaterialID(double _coords[]);
-  std::map<unsigned int, std::vector<double> > eulerAngles;
+  unsigned int getVoxelMaterialID(unsigned int _voxelIndex[]);
+  //euler angles (followed by the phase and the additional voxel data) of a grain
+  const double* getEulerAngles(unsigned int _grainID);
+  //bytes of the voxel and orientation tables owned by this process (the first process of each node)
+  std::size_t memory_consumption() const;
 private:
-  std::map<double,std::map<double, std::map<double, unsigned int> > > inputVoxelData;
+  //The read-only voxel and orientation tables are stored once per node in MPI-3 shared memory
+  //windows. They are read and written by the first process of the node (nodeComm), the other
+  //processes of the node access them through the pointers below.
+  MPI_Comm nodeComm;
+  unsigned int nodeRank;
+  //grain IDs of the voxels, indexed by (x*numPts[1]+y)*numPts[2]+z
+  MPI_Win voxelGrainIDsWindow;
+  unsigned int* voxelGrainIDs;
+  std::vector<unsigned int> numVoxels;
+  std::vector<double> voxelSize;
+  //euler angles table, numEulerColumns values per grain ID from 0 to numEulerRows-1
+  MPI_Win eulerAnglesWindow;
+  double* eulerAngles;
+  unsigned int numEulerRows, numEulerColumns;
   dealii::ConditionalOStream  pcout;
 };
@@ -5,10 +5,20 @@
 //dealii headers
 #include "ellipticBVP.h"
 #include "crystalOrientationsIO.h"
+#include "quadratureHistory.h"
+#include "matrixExponential.h"
 
 typedef struct {
   FullMatrix<double> m_alpha,n_alpha, eulerAngles2;
 } materialProperties;
+
+//latent hardening ratios q_ij in block form: q_ij=blockRatio(group[i],group[j]) for i!=j and
+//q_ii=selfRatio(i)
+typedef struct {
+  std::vector<unsigned int> group;
+  FullMatrix<double> blockRatio;
+  Vector<double> selfRatio;
+} latentHardeningBlocks;
 //material model class for crystal plasticity
 //derives from ellipticBVP base abstract class
 template <int dim>
@@ -23,7 +33,11 @@ public:
   *calculates the texture of the deformed polycrystal
   */
   void reorient();
-  void reorient2(Vector<double> &rnew, Vector<double> rold, FullMatrix<double> FE_tau, FullMatrix<double> FE_t);
+  void reorient2(Vector<double> &rnew, const Vector<double> &rold, const FullMatrix<double> &FE_tau, const FullMatrix<double> &FE_t);
+  /**
+  *rotation R of the polar decomposition F=RU of a 3x3 matrix, in closed form
+  */
+  void polarRotation(const FullMatrix<double> &F, double R[3][3]);
   /**
   *Initiation of Multiphase in calculatePlasticity.cc
   */
@@ -63,7 +77,7 @@ public:
       PA-active slip systems
       */
       void inactive_slip_removal(Vector<double> &active,Vector<double> &x_beta_old, Vector<double> &x_beta, unsigned int &n_PA, unsigned int &n_Tslip_systems_Region,
-        Vector<double> &PA, Vector<double> b,FullMatrix<double> A,FullMatrix<double> &A_PA);
+        Vector<double> &PA, const Vector<double> &b, const FullMatrix<double> &A, FullMatrix<double> &A_PA);
 
         /**
         * Structure to hold material parameters
@@ -78,6 +92,12 @@ public:
 
         void init2(unsigned int num_quad_points);
 
+        /**
+        * Whether the history field (orientation, slip resistance, backstress, twin fraction or
+        * state variables) is stored in single precision
+        */
+        bool singlePrecisionHistory(const std::string &fieldName) const;
+
         void setBoundaryValues(const Point<dim>& node, const unsigned int dof, bool& flag, double& value);
         /**
         * Updates the stress and tangent modulus at a given quadrature point in a element for
@@ -89,6 +109,20 @@ public:
         void calculatePlasticity(unsigned int cellID,
           unsigned int quadPtID, unsigned int StiffnessCalFlag);
 
+        /**
+        * Integrates the constitutive model from the start state (FE_t_sub, FP_t_sub, s_alpha_t_sub,
+        * W_kh_t_sub, slip and twin fractions) to the current F. Returns false if the material point
+        * solve failed, in which case calculatePlasticity() splits the increment into substeps.
+        */
+        bool calculatePlasticitySubstep(unsigned int cellID,
+          unsigned int quadPtID, unsigned int StiffnessCalFlag);
+
+        /**
+        * Stores the end state of a (sub)step (FE_tau, FP_tau, sres_tau, Wkh_tau) in the iteration
+        * history and applies the reorientation due to twinning
+        */
+        void commitSubstepHistory(unsigned int cellID, unsigned int quadPtID);
+
           void getElementalValues(FEValues<dim>& fe_values,
             unsigned int dofs_per_cell,
             unsigned int num_quad_points,
@@ -106,10 +140,44 @@ public:
 
               void updateBeforeIncrement();
 
+              void resetIncrementHistory();
+
+              /**
+              * Migration of the quadrature point history of a cell when the triangulation is repartitioned, refined or coarsened
+              */
+              void packCellData(const std::vector<std::pair<unsigned int,unsigned int> >& sources, std::vector<double>& data);
+              void resizeCellData(unsigned int numLocalCells);
+              void unpackCellData(unsigned int cellID, const std::vector<unsigned int>& quadPtMap, const std::vector<double>& data);
+
+              /**
+              * Mean plastic deformation of a cell, used as the adaptive refinement indicator
+              */
+              double getCellRefinementIndicator(unsigned int cellID);
+
+              /**
+              * Memory consumption of the history arrays, quadrature output and orientation tables
+              */
+              void addMemoryConsumption(std::vector<std::pair<std::string,std::size_t> >& entries);
+
+              /**
+              * Grain ID of a voxel of the voxel aligned mesh
+              */
+              unsigned int getVoxelGrainID(unsigned int voxelIndex[]);
+
               void writeQuadratureOutput(std::string _outputDirectory, unsigned int _currentIncrement);
 
               void addToQuadratureOutput(std::vector<double>& _QuadOutputs);
 
+              /**
+              *sizes the per-grain accumulators using the largest grain ID over all processors
+              */
+              void initGrainAveragedOutput();
+
+              /**
+              *reduces the per-grain sums over all processors and writes the grain averaged table
+              */
+              void writeGrainAveragedOutput(std::string _outputDirectory, unsigned int _currentIncrement);
+
               /**
               *calculates the rotation matrix (OrientationMatrix) from the rodrigues vector (r)
               */
@@ -155,24 +223,34 @@ public:
               void elasticmoduli(FullMatrix<double> &Ar, FullMatrix<double> R, FullMatrix<double> Av);
 
               /**
-              *calculates the matrix exponential of 3x3 matrix A
+              *groups the slip and twin systems by the block structure of the latent hardening ratios
+              */
+              void compressLatentHardening(const FullMatrix<double> &q_phase, latentHardeningBlocks &blocks);
+
+              /**
+              *product of the latent hardening ratios of the current phase with a vector, in block form
               */
-              FullMatrix<double> matrixExponential(FullMatrix<double> A);
+              void latentHardeningVmult(Vector<double> &result, const Vector<double> &v);
+
+              /**
+              *calculates the matrix exponential of 3x3 matrix A (see matrixExponential.h)
+              */
+              FullMatrix<double> matrixExponential(const FullMatrix<double> &A);
 
 	      /**
-	      *calculates the matrix exponential of 3x3 matrix A
+	      *calculates the matrix exponential of 6x6 matrix A
 	      */
-	      FullMatrix<double> matrixExponential6(FullMatrix<double> A);
+	      FullMatrix<double> matrixExponential6(const FullMatrix<double> &A);
 
               /**
-	      *calculates the matrix exponential of 3x3 matrix A
+	      *calculates the Gateaux derivative of the matrix exponential of 3x3 matrix A in the direction B
 	      */
-              FullMatrix<double> matrixExponentialGateauxDerivative(FullMatrix<double> A, FullMatrix<double> B);
+              FullMatrix<double> matrixExponentialGateauxDerivative(const FullMatrix<double> &A, const FullMatrix<double> &B);
 
               /**
-	       *calculates the matrix exponential of 3x3 matrix A
+	       *calculates the Gateaux derivative of the matrix exponential of 3x3 matrix A in the direction B
 	       */
-	      FullMatrix<double> matrixExponentialGateauxDerivative2(FullMatrix<double> A, FullMatrix<double> B);
+	      FullMatrix<double> matrixExponentialGateauxDerivative2(const FullMatrix<double> &A, const FullMatrix<double> &B);
 
 
 	      /**
@@ -200,6 +278,19 @@ public:
               */
               FullMatrix<double> FE_tau;
 
+              /**
+              * State at the start of a material point substep (the converged state without substepping)
+              */
+              FullMatrix<double> FE_t_sub, FP_t_sub;
+              Vector<double> s_alpha_t_sub, W_kh_t_sub;
+              std::vector<double> slipfraction_t_sub, twinfraction_t_sub;
+
+              /**
+              * Fraction of the increment covered by the current substep (1 without substepping),
+              * used to scale the warm start slip increments
+              */
+              double substepFraction;
+
               /**
               * Cauchy Stress T
               */
@@ -238,15 +329,23 @@ public:
               double No_Elem, N_qpts,local_F_e,local_F_r,F_e,F_r,local_microvol,microvol,F_s,local_F_s,F_T;
 
               std::vector<std::vector<double> > outputQuadrature;
+
+              /**
+              * Volume weighted per-grain sums indexed by grainID*numGrainAveragedFields. Per grain:
+              * volume, Cauchy stress (6), Lagrangian strain (6), total slip, twin fraction and orientation quaternion (4)
+              */
+              std::vector<double> local_grainSums, global_grainSums;
+              unsigned int n_grains, numGrainAveragedFields;
               /**
               * Stores original crystal orientations as rodrigues vectors by element number and quadratureID
               */
-              std::vector<std::vector<  Vector<double> > >  rot_conv,rot_iter,rot;
+              quadratureHistory rot_conv,rot_iter;
+              std::vector<std::vector<  Vector<double> > >  rot;
 
               /**
               * Stores deformed crystal orientations as rodrigues vectors by element number and quadratureID
               */
-              std::vector<std::vector<  Vector<double> > >  rotnew_conv,rotnew_iter;
+              quadratureHistory rotnew_conv,rotnew_iter;
 
               /**
               * Stores the additional voxel data by element number and quadratureID
@@ -287,21 +386,29 @@ public:
               /**
               * Stores slip resistance by element number and quadratureID at each iteration
               */
-              std::vector<std::vector<  Vector<double> > >  s_alpha_iter;
+              quadratureHistory s_alpha_iter;
 
-              std::vector<std::vector<  Vector<double> > >  s_alpha_conv;
+              quadratureHistory s_alpha_conv;
 
-              std::vector<std::vector<  Vector<double> > >  W_kh_conv, W_kh_iter;
+              quadratureHistory W_kh_conv, W_kh_iter;
               Vector<double> Wkh_tau;
 
 	      FullMatrix<double> T_inter ;
               /**
               * Stores state variables by element number and quadratureID
               */
-              std::vector<std::vector<  Vector<double> > >  stateVar_conv,stateVar_iter;
+              quadratureHistory stateVar_conv,stateVar_iter;
               Vector<double> UserMatConstants;
 
-              std::vector<std::vector<  std::vector<double> > >  twinfraction_iter, slipfraction_iter,twinfraction_conv, slipfraction_conv,TwinOutputfraction_iter,TwinOutputfraction_conv;
+              quadratureHistory twinfraction_iter, twinfraction_conv;
+              std::vector<std::vector<  std::vector<double> > >  slipfraction_iter, slipfraction_conv,TwinOutputfraction_iter,TwinOutputfraction_conv;
+
+              /**
+              * Slip increments of the last solve at each quadrature point, normalized to the full
+              * increment (zero on the inactive systems, empty before the first plastic solve).
+              * Warm start of the active slip search
+              */
+              std::vector<std::vector<Vector<double> > > slipIncrement_iter;
               std::vector<std::vector<std::vector<unsigned int> > >	TwinFlag_conv, ActiveTwinSystems_conv, TwinFlag_iter, ActiveTwinSystems_iter;
               std::vector<std::vector<unsigned int> > NumberOfTwinnedRegion_conv, TwinMaxFlag_iter, TwinMaxFlag_conv, NumberOfTwinnedRegion_iter;
               std::vector<std::vector<double> >  twin_ouput, TotaltwinvfK;
@@ -313,6 +420,12 @@ public:
               unsigned int n_slip_systems,n_Tslip_systems,n_twin_systems,n_slip_systems_SinglePhase,n_Tslip_systems_SinglePhase,n_twin_systems_SinglePhase, phaseMaterial, numberofPhases, n_UserMatStateVar, n_UserMatStateVar_SinglePhase; //No. of slip systems
               FullMatrix<double> m_alpha,n_alpha,m_alpha_SinglePhase,n_alpha_SinglePhase,m_alpha_MultiPhase,n_alpha_MultiPhase,q,q_phase1,q_phase2,q_phase3,q_phase4,sres,Dmat,Dmat_SinglePhase,Dmat_MultiPhase, eulerAngles2;
 
+              /**
+              * Latent hardening ratios of each phase in block form, and those of the current phase
+              */
+              latentHardeningBlocks qBlocks_phase1,qBlocks_phase2,qBlocks_phase3,qBlocks_phase4;
+              const latentHardeningBlocks *qBlocks;
+
               double twinShear;
               Vector<double> initialHardeningModulus, saturationStress, powerLawExponent, initialHardeningModulusTwin, saturationStressTwin, powerLawExponentTwin;
 
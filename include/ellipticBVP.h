@@ -38,24 +38,19 @@ protected:
   IndexSet   locally_owned_dofs_Scalar;
   IndexSet   locally_relevant_dofs,locally_relevant_dofs_Mod;
   IndexSet   locally_relevant_dofs_Scalar;
-  IndexSet   dof_FN,dof_FP;
+  IndexSet   dof_FN;
   IndexSet   dof_FXN,dof_FXP;
   IndexSet   dof_FYN,dof_FYP;
   IndexSet   dof_FZN,dof_FZP;
-  IndexSet   dof_Boundary_Layer2,vertices_DOFs,global_dof_Boundary_Layer2,Edges_DOFs_1,Edges_DOFs_2,Edges_DOFs_3;
+  IndexSet   dof_Boundary_Layer2,vertices_DOFs;
 
-
-  unsigned int globalDOF_V000_1,globalDOF_V000_2,globalDOF_V000_3,globalDOF_V001_1,globalDOF_V001_2,globalDOF_V001_3,globalDOF_V010_1,globalDOF_V010_2,globalDOF_V010_3,globalDOF_V100_1,globalDOF_V100_2,globalDOF_V100_3;
-  unsigned int globalDOF_V011_1,globalDOF_V011_2,globalDOF_V011_3,globalDOF_V110_1,globalDOF_V110_2,globalDOF_V110_3,globalDOF_V101_1,globalDOF_V101_2,globalDOF_V101_3,globalDOF_V111_1,globalDOF_V111_2,globalDOF_V111_3;
-
-  unsigned int local_globalDOF_V000_1,local_globalDOF_V000_2,local_globalDOF_V000_3,local_globalDOF_V001_1,local_globalDOF_V001_2,local_globalDOF_V001_3,local_globalDOF_V010_1,local_globalDOF_V010_2,local_globalDOF_V010_3,local_globalDOF_V100_1,local_globalDOF_V100_2,local_globalDOF_V100_3;
-  unsigned int local_globalDOF_V011_1,local_globalDOF_V011_2,local_globalDOF_V011_3,local_globalDOF_V110_1,local_globalDOF_V110_2,local_globalDOF_V110_3,local_globalDOF_V101_1,local_globalDOF_V101_2,local_globalDOF_V101_3,local_globalDOF_V111_1,local_globalDOF_V111_2,local_globalDOF_V111_3;
-
-  unsigned int global_size_dof_Boundary_Layer2,global_size_dof_Edge;
+  unsigned int global_size_dof_Boundary_Layer2;
 
   std::vector<unsigned int> global_vector_dof_Boundary_Layer2;
   std::vector<std::vector<unsigned int> >  vertices_Constraints_Matrix,edges_Constraints_Matrix,faces_Constraints_Matrix, global_Edges_DOFs_Vector_Array;
-  std::vector<std::vector<double>>  vertices_Constraints_Coef,edges_Constraints_Coef,faces_Constraints_Coef, global_Edges_DOFs_Coord_Vector_Array;
+  std::vector<std::vector<double>>  vertices_Constraints_Coef,edges_Constraints_Coef,faces_Constraints_Coef;
+  //periodic face pairs in x, y and z directions, collected once in setPeriodicityConstraintsInit
+  std::vector<GridTools::PeriodicFacePair<typename DoFHandler<dim>::cell_iterator> > periodicity_vectorX,periodicity_vectorY,periodicity_vectorZ;
   std::vector<std::vector<int>> periodicBCsInput; // 	Periodic BCs Input
   std::vector<std::vector<double>> periodicBCsInput2,periodicBCsInput2_Orig; // 	Periodic BCs Input
   std::vector<unsigned int> vertices_Constraint_Known, vertices_DOFs_vector;
@@ -82,7 +77,7 @@ protected:
   void assemble();
   void assemble2();
   #if ((DEAL_II_VERSION_MAJOR < 9)||(DEAL_II_VERSION_MINOR < 1))
-  ConstraintMatrix   constraints, constraints_PBCs_Inc0, constraints_PBCs_IncNot0, constraints_PBCs_Inc0Neg;
+  ConstraintMatrix   constraints;
   ConstraintMatrix   constraintsMassMatrix;
   void solveLinearSystem(ConstraintMatrix& constraintmatrix, matrixType& A, vectorType& b, vectorType& x, vectorType& xGhosts, vectorType& dxGhosts);
   void solveLinearSystem2(ConstraintMatrix& constraintmatrix, matrixType& A, vectorType& b, vectorType& x, vectorType& xGhosts, vectorType& dxGhosts);
@@ -91,7 +86,7 @@ protected:
   void setEdgeConstraints(ConstraintMatrix& constraintmatrix);
   void setNodeConstraints(ConstraintMatrix& constraintmatrix);
   #else
-  AffineConstraints<double>   constraints, constraints_PBCs_Inc0, constraints_PBCs_IncNot0, constraints_PBCs_Inc0Neg;
+  AffineConstraints<double>   constraints;
   AffineConstraints<double>   constraintsMassMatrix;
   void solveLinearSystem(AffineConstraints<double>& constraintmatrix, matrixType& A, vectorType& b, vectorType& x, vectorType& xGhosts, vectorType& dxGhosts);
   void solveLinearSystem2(AffineConstraints<double>& constraintmatrix, matrixType& A, vectorType& b, vectorType& x, vectorType& xGhosts, vectorType& dxGhosts);
@@ -105,11 +100,21 @@ protected:
 
 
   bool solveNonLinearSystem();
+  void predictSolution();
+  void applyPredictionToConstraints();
   void solve();
   void output();
   void initProjection();
   void projection();
   void markBoundaries();
+  void checkUniformCartesianMesh();
+  //grain ID of a voxel (x,y,z indices) of the voxel aligned mesh
+  virtual unsigned int getVoxelGrainID(unsigned int voxelIndex[]);
+  bool setVoxelMaterialIDs(bool flagMixedCells);
+  const Mapping<dim>& getMapping() const;
+  //locally owned cells in cellID order, and the grain size of the thread-parallel loops over them
+  void getLocallyOwnedCells(const DoFHandler<dim>& _dofHandler, std::vector<typename DoFHandler<dim>::active_cell_iterator>& cells) const;
+  unsigned int getThreadGrainSize(unsigned int numItems) const;
 
   //virtual methods to be implemented in derived class
   //method to calculate elemental Jacobian and Residual,
@@ -132,31 +137,70 @@ protected:
       //methods to allow for pre/post increment updates
       virtual void updateBeforeIncrement();
       virtual void updateAfterIncrement();
+      virtual void resetIncrementHistory();
+
+      //methods to migrate the quadrature point history of the material model with its cells
+      //when the triangulation is repartitioned, refined or coarsened. The history of quadrature
+      //point q is packed from quadrature point sources[q].second of cell sources[q].first, and
+      //quadrature point q of the unpacked cell takes the packed value quadPtMap[q].
+      virtual void packCellData(const std::vector<std::pair<unsigned int,unsigned int> >& sources, std::vector<double>& data);
+      virtual void resizeCellData(unsigned int numLocalCells);
+      virtual void unpackCellData(unsigned int cellID, const std::vector<unsigned int>& quadPtMap, const std::vector<double>& data);
+      void transferToNewMesh(bool refineAndCoarsen);
+      void repartition();
+
+      //adaptive mesh refinement
+      virtual double getCellRefinementIndicator(unsigned int cellID);
+      void adaptMesh();
+
+      //memory consumption report: bytes of the main data structures on each processor (min, max
+      //and total over the processors). The derived material model class adds its own data
+      //structures as (name, bytes) entries.
+      void reportMemoryConsumption();
+      virtual void addMemoryConsumption(std::vector<std::pair<std::string,std::size_t> >& entries);
 
       //methods to apply dirichlet BC's and initial conditions
       void applyDirichletBCs();
       void applyInitialConditions();
       void setBoundaryValues(const Point<dim>& node, const unsigned int dof, bool& flag, double& value);
+      void initDirichletBCs();
+      bool nodeOnFace(const Point<dim>& node, const unsigned int face);
+      void getBoundaryType(const Point<dim>& node, const unsigned int dof, bool& flag, unsigned int& bcType, unsigned int& face);
+      double getBoundaryValue(const Point<dim>& node, const unsigned int dof, const unsigned int bcType, const unsigned int face);
+      enum dirichletBCType {cyclicBC, simpleBC, tabularBC, velocityGradientBC, dicBC};
 
       ///////These functions are for Periodic BCs Implementation
       void setPeriodicity();
       void setPeriodicityConstraintsInit();
       void setPeriodicityConstraints();
-      void setPeriodicityConstraintsInc0();
-      void setPeriodicityConstraintsIncNot0();
-      void setPeriodicityConstraintsInc0Neg();
+      void initPeriodicityConstraints();
       
       ///////These functions are for DIC BCs evaluation
-      void bcFunction1(double _yval, double &value_x, double &value_y, double _currentIncr);
-      void bcFunction2(double _yval, double &value_x, double &value_y, double _currentIncr);
-      void bcFunction3(double _yval, double &value_x, double &value_y, double _currentIncr);
-      void bcFunction4(double _yval, double &value_x, double &value_y, double _currentIncr);
+      void initDICBCs();
+      void findDICSamples(const unsigned int face, const double coord, unsigned int& index, double& weight);
+      double getDICValue(const unsigned int face, const unsigned int dof, const unsigned int index, const double weight);
+      void advanceTimeCounter(const std::vector<double>& timeTable);
 
 
       std::map<types::global_dof_index, Point<dim> > supportPoints;
 
+      //constrained boundary DOFs with their component, BC type, face and support point
+      std::vector<types::global_dof_index> dirichletDOFs;
+      std::vector<unsigned int> dirichletDOFComponents, dirichletDOFTypes, dirichletDOFFaces;
+      std::vector<Point<dim> > dirichletDOFNodes;
+      bool reuseDirichletConstraints;
+
+      //inhomogeneous lines of the closed periodic constraints at increment 0 of a timestep
+      std::vector<types::global_dof_index> periodicInhomogeneousDOFs;
+      std::vector<double> periodicInhomogeneities;
+      Vector<double> externalMeshParameterBCs;
+
       //parallel data structures
       vectorType solution, oldSolution, residual;
+      //converged solution of the increment before oldSolution, used by the extrapolation predictor
+      vectorType previousIncrementSolution;
+      //displacement increment added by the extrapolation predictor in the current increment
+      vectorType predictedSolutionIncWithGhosts;
       vectorType solutionWithGhosts, solutionIncWithGhosts;
       matrixType jacobian;
 
@@ -169,6 +213,11 @@ protected:
       double currentTime;
       /////DIC bc names
       FullMatrix<double> bc_new1,bc_new2,bc_new3,bc_new4;
+      //sorted DIC sample coordinates and displacement rates per time interval for the four lateral faces
+      std::vector<std::vector<double> > dicCoords, dicRates;
+      //DIC sample index and interpolation weight of each constrained boundary DOF
+      std::vector<unsigned int> dirichletDICIndex;
+      std::vector<double> dirichletDICWeight;
 
       FullMatrix<double> Fprev=IdentityMatrix(dim);
       FullMatrix<double> F,deltaF;
@@ -179,7 +228,23 @@ protected:
       unsigned int totalIncrements,periodicTotalIncrements;
       bool resetIncrement;
       double loadFactorSetByModel;
+
+      //factor (>=1) applied to the material point tolerances in the current nonlinear iteration
+      double localToleranceFactor;
       double totalLoadFactor;
+      double previousLoadFactor;
+      //whether the current increment starts from a predicted solution, and the constraint lines whose
+      //inhomogeneities were changed for it in the first iteration (with their original inhomogeneity)
+      bool solutionPredicted;
+      std::vector<std::pair<types::global_dof_index,double> > predictorConstraintLines;
+
+      //constitutive cost (assembly time) of each locally owned cell since the last repartitioning
+      std::vector<double> cellCost;
+
+      //all cells are axis-aligned bricks (FEValues then use the Cartesian mapping), and all of the same size
+      bool cartesianMesh, uniformCartesianMesh;
+      MappingCartesian<dim> mappingCartesian;
+      MappingQ1<dim,dim> mappingQ1;
 
       //parallel message stream
       ConditionalOStream  pcout;
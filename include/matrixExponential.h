@@ -0,0 +1,19 @@
+//matrix exponential of 3x3 matrices and its Gateaux derivative
+#ifndef MATRIXEXPONENTIAL_H
+#define MATRIXEXPONENTIAL_H
+
+#include <deal.II/base/tensor.h>
+
+using namespace dealii;
+
+/**
+*exp(A) by scaling and squaring with the diagonal (6,6) Pade approximant
+*/
+Tensor<2,3,double> matrixExponential3(const Tensor<2,3,double> &A);
+
+/**
+*exp(A) and its Gateaux derivative in the direction B (d/dh exp(A+h*B) at h=0) in one pass
+*/
+void matrixExponentialAndGateauxDerivative3(const Tensor<2,3,double> &A, const Tensor<2,3,double> &B, Tensor<2,3,double> &expA, Tensor<2,3,double> &dExpA);
+
+#endif
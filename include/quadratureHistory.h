@@ -0,0 +1,112 @@
+//class to store a history variable (a vector of values) of every quadrature point of the locally owned cells
+#ifndef QUADRATUREHISTORY_H
+#define QUADRATUREHISTORY_H
+
+#include "dealIIheaders.h"
+
+using namespace dealii;
+
+//The values of all quadrature points are stored in one contiguous array, indexed by
+//(cellID*numQuadPoints+quadPtID)*numComponents+i, in double or in single precision. Values are
+//always read and written as double, so the material model computes in double precision with either
+//storage; single precision storage rounds every stored value to a relative accuracy of about 6e-8.
+class quadratureHistory{
+public:
+  quadratureHistory();
+  /**
+  *allocates numCells*numQuadPoints points, each initialized to the values of initial
+  */
+  void reinit(unsigned int numCells, unsigned int numQuadPoints, const Vector<double> &initial, bool singlePrecision);
+  void reinit(unsigned int numCells, unsigned int numQuadPoints, const std::vector<double> &initial, bool singlePrecision);
+  /**
+  *changes the number of cells (values of new cells are zero)
+  */
+  void resize(unsigned int numCells);
+  /**
+  *copies the values of the cells [begin,end) from source (with the same layout)
+  */
+  void copyCells(const quadratureHistory &source, unsigned int begin, unsigned int end);
+  //number of cells (zero if the field is not allocated), quadrature points per cell and values per quadrature point
+  unsigned int size() const {return numCells;}
+  unsigned int n_quadrature_points() const {return numQuadPoints;}
+  unsigned int n_components() const {return numComponents;}
+  bool isSinglePrecision() const {return singlePrecision;}
+  /**
+  *value i of a quadrature point
+  */
+  double operator()(unsigned int cellID, unsigned int quadPtID, unsigned int i) const{
+    const std::size_t index=(std::size_t(cellID)*numQuadPoints+quadPtID)*numComponents+i;
+    return singlePrecision ? floatValues[index] : doubleValues[index];
+  }
+  void set(unsigned int cellID, unsigned int quadPtID, unsigned int i, double value){
+    const std::size_t index=(std::size_t(cellID)*numQuadPoints+quadPtID)*numComponents+i;
+    if (singlePrecision) floatValues[index]=value;
+    else doubleValues[index]=value;
+  }
+  /**
+  *all values of a quadrature point
+  */
+  void get(unsigned int cellID, unsigned int quadPtID, Vector<double> &values) const;
+  void get(unsigned int cellID, unsigned int quadPtID, std::vector<double> &values) const;
+  void set(unsigned int cellID, unsigned int quadPtID, const Vector<double> &values);
+  void set(unsigned int cellID, unsigned int quadPtID, const std::vector<double> &values);
+
+  //proxies giving the nested vector syntax field[cellID][quadPtID] and field[cellID][quadPtID][i]
+  //of the previous std::vector<std::vector<Vector<double> > > storage, so the material models in
+  //MaterialModels/ which are copied over calculatePlasticity.cc compile unchanged
+  class valueProxy{
+  public:
+    valueProxy(quadratureHistory &_field, unsigned int _cellID, unsigned int _quadPtID, unsigned int _i):
+      field(_field), cellID(_cellID), quadPtID(_quadPtID), i(_i) {}
+    operator double() const {return field(cellID, quadPtID, i);}
+    valueProxy& operator=(double value) {field.set(cellID, quadPtID, i, value); return *this;}
+    valueProxy& operator=(const valueProxy &other) {return *this=double(other);}
+    valueProxy& operator+=(double value) {return *this=double(*this)+value;}
+    valueProxy& operator-=(double value) {return *this=double(*this)-value;}
+    valueProxy& operator*=(double value) {return *this=double(*this)*value;}
+    valueProxy& operator/=(double value) {return *this=double(*this)/value;}
+  private:
+    quadratureHistory &field;
+    const unsigned int cellID, quadPtID, i;
+  };
+  class pointProxy{
+  public:
+    pointProxy(quadratureHistory &_field, unsigned int _cellID, unsigned int _quadPtID):
+      field(_field), cellID(_cellID), quadPtID(_quadPtID) {}
+    valueProxy operator[](unsigned int i) {return valueProxy(field, cellID, quadPtID, i);}
+    double operator[](unsigned int i) const {return field(cellID, quadPtID, i);}
+    valueProxy operator()(unsigned int i) {return valueProxy(field, cellID, quadPtID, i);}
+    double operator()(unsigned int i) const {return field(cellID, quadPtID, i);}
+    unsigned int size() const {return field.n_components();}
+    operator Vector<double>() const {Vector<double> values; field.get(cellID, quadPtID, values); return values;}
+    operator std::vector<double>() const {std::vector<double> values; field.get(cellID, quadPtID, values); return values;}
+    pointProxy& operator=(const Vector<double> &values) {field.set(cellID, quadPtID, values); return *this;}
+    pointProxy& operator=(const std::vector<double> &values) {field.set(cellID, quadPtID, values); return *this;}
+    pointProxy& operator=(const pointProxy &other) {return *this=std::vector<double>(other);}
+  private:
+    quadratureHistory &field;
+    const unsigned int cellID, quadPtID;
+  };
+  class cellProxy{
+  public:
+    cellProxy(quadratureHistory &_field, unsigned int _cellID): field(_field), cellID(_cellID) {}
+    pointProxy operator[](unsigned int quadPtID) {return pointProxy(field, cellID, quadPtID);}
+    unsigned int size() const {return field.n_quadrature_points();}
+  private:
+    quadratureHistory &field;
+    const unsigned int cellID;
+  };
+  cellProxy operator[](unsigned int cellID) {return cellProxy(*this, cellID);}
+
+  /**
+  *bytes allocated for the values
+  */
+  std::size_t memory_consumption() const;
+private:
+  unsigned int numCells, numQuadPoints, numComponents;
+  bool singlePrecision;
+  std::vector<double> doubleValues;
+  std::vector<float> floatValues;
+};
+
+#endif
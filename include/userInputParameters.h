@@ -35,6 +35,8 @@ public:
   bool writeMeshToEPS; //Only written for serial runs and if number of elements < 10000
 
   bool readExternalMesh;
+  bool voxelAlignedMesh; // Coarse mesh cells coincide with the voxels of the grain ID file, grain IDs are stored as material_id
+  unsigned int grainInteriorCoarseningLevels; // Number of octree levels by which voxels inside a grain are merged in the voxel aligned mesh
   std::string externalMeshFileName;
   double externalMeshParameter;
   double delT; // Time increment
@@ -59,6 +61,7 @@ public:
   unsigned int DIC_InputStepNumber, X_dic, Y_dic, Z_dic; //Number of Input data for DIC experiment
   std::vector<double> timeInputDIC; //Table for Time intervals of DIC experiment input
   std::string DIC_BCfilename1,DIC_BCfilename2,DIC_BCfilename3,DIC_BCfilename4; // DIC Boundary conditions file
+  bool enableDICLinearInterpolation; // Linear interpolation between DIC points instead of the nearest DIC point
 
 
   bool enableCyclicLoading;
@@ -82,6 +85,9 @@ public:
   std::vector<double> tabularTimeOutput; // 	Periodic BCs Input
   std::string outputDirectory;
   unsigned int skipOutputSteps, skipQuadratureOutputSteps;
+  bool writeGrainAveragedOutput; // flag to write volume averaged quantities per grain
+  bool writeMemoryReportPerIncrement; // flag to print the memory consumption report after every increment (it is always printed at initialization and after the first increment)
+  unsigned int skipGrainAveragedOutputSteps;
   bool output_Eqv_strain;
   bool output_Eqv_stress;
   bool output_Grain_ID;
@@ -94,13 +100,30 @@ public:
   double absNonLinearTolerance; // Non-linear solver tolerance
   double relNonLinearTolerance; // Relative non-linear solver tolerance
   bool stopOnConvergenceFailure; // Flag to stop problem if convergence fails
+  bool enableNonLinearConvergenceCheck; // Flag to end the nonlinear iterations once the absolute or relative tolerance is met (the residual after the last iteration is also tested with adaptive time stepping)
   bool enableStiffnessFirstIter; //Flag to enable the calculation of stiffness matrix only for the first iteration of each increment
+  bool enableExtrapolationPredictor; //Flag to start each increment from the displacements extrapolated from the last two converged increments
+  bool enableInexactLocalTolerance; //Flag to loosen the material point tolerances in proportion to the relative residual of the nonlinear iterations
+  double maxLocalToleranceFactor; //Largest factor by which the material point tolerances are loosened
 
   /*Adaptive time-stepping parameters*/
   bool enableAdaptiveTimeStepping; //Flag to enable adaptive time steps
   double adaptiveLoadStepFactor; // Load step factor
   double adaptiveLoadIncreaseFactor;
   double succesiveIncForIncreasingTimeStep;
+  unsigned int maxIncrementCutbacks; // Maximum number of successive cutbacks of an increment
+
+  /*Load balancing parameters*/
+  bool enableCostWeightedRepartition; //Flag to repartition the mesh using the measured constitutive cost of the cells
+  unsigned int repartitionInterval; // Number of increments between repartitionings
+  unsigned int numThreadsPerProcess; // Number of threads of each MPI process for the thread-parallel post-processing cell loops
+
+  /*Adaptive mesh refinement parameters*/
+  bool enableAdaptiveRefinement; //Flag to refine and coarsen the mesh during the simulation
+  unsigned int adaptiveRefinementInterval; // Number of increments between mesh adaptations
+  std::string adaptiveRefinementIndicator; //Refinement indicator (plasticStrain or Kelly)
+  double adaptiveRefineFraction, adaptiveCoarsenFraction; // Fractions of the indicator of the refined and coarsened cells
+  unsigned int maxAdaptiveRefinementLevels; // Maximum number of refinement levels above the initial mesh
   unsigned int additionalVoxelInfo; // Additional Voxel info in addition to three orientation components
   bool enableMultiphase; //Flag to indicate if Multiphase is enabled
   unsigned int numberofPhases; // Number of phases
@@ -150,8 +173,11 @@ public:
   // Crystal Plasticity Constitutive model tolerances (for advanced users)
   double modelStressTolerance; // Stress tolerance for the yield surface (MPa)
   unsigned int modelMaxSlipSearchIterations; // Maximum no. of active slip search iterations
+  unsigned int modelMaxSubsteps; // Maximum no. of substeps of the material point increment if the constitutive update fails
+  bool enableSlipWarmStart; // Flag to start the active slip search from the active set and slip increments of the last solve at the material point
   unsigned int modelMaxSolverIterations; // Maximum no. of iterations to achieve non-linear convergence
   double modelMaxPlasticSlipL2Norm; // L2-Norm of plastic slip strain-used for load-step adaptivity
+  std::vector<std::string> singlePrecisionHistoryFields; // History fields of the quadrature points stored in single precision
 
   //Read Input Microstructure
   std::string grainIDFile; // Grain ID File
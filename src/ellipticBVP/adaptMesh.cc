@@ -0,0 +1,62 @@
+//adaptive mesh refinement method for ellipticBVP class
+#include "../../include/ellipticBVP.h"
+
+//refine and coarsen the mesh using the plasticity indicator of the material model or the Kelly
+//error estimate of the displacement field, and transfer the history to the new mesh
+template <int dim>
+void ellipticBVP<dim>::adaptMesh(){
+  //the periodicity constraint data is tied to the initial mesh
+  if (userInputs.enablePeriodicBCs){
+    pcout << "adaptive refinement is not supported with periodic BCs, skipping\n";
+    return;
+  }
+
+  computing_timer.enter_section("adaptive refinement");
+
+  Vector<float> refinementIndicator(triangulation.n_active_cells());
+  if (userInputs.adaptiveRefinementIndicator=="Kelly"){
+    KellyErrorEstimator<dim>::estimate(dofHandler,
+      QGauss<dim-1>(userInputs.quadOrder),
+      std::map<types::boundary_id, const Function<dim>*>(),
+      solutionWithGhosts,
+      refinementIndicator);
+  }
+  else{
+    typename DoFHandler<dim>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
+    unsigned int cellID=0;
+    for (; cell!=endc; ++cell) {
+      if (cell->is_locally_owned()){
+        refinementIndicator(cell->active_cell_index())=getCellRefinementIndicator(cellID++);
+      }
+    }
+  }
+
+  parallel::distributed::GridRefinement::refine_and_coarsen_fixed_fraction(triangulation,
+    refinementIndicator,
+    userInputs.adaptiveRefineFraction,
+    userInputs.adaptiveCoarsenFraction);
+
+  //cells are kept between the initial mesh and the maximum refinement level
+  const unsigned int minLevel=userInputs.readExternalMesh ? 0 : userInputs.meshRefineFactor;
+  const unsigned int maxLevel=minLevel+userInputs.maxAdaptiveRefinementLevels;
+  typename parallel::distributed::Triangulation<dim>::active_cell_iterator triaCell = triangulation.begin_active(), triaEndc = triangulation.end();
+  for (; triaCell!=triaEndc; ++triaCell) {
+    if (triaCell->is_locally_owned()){
+      if (triaCell->level()>=(int)maxLevel) triaCell->clear_refine_flag();
+      if (triaCell->level()<=(int)minLevel) triaCell->clear_coarsen_flag();
+    }
+  }
+  triangulation.prepare_coarsening_and_refinement();
+
+  transferToNewMesh(true);
+
+  pcout << "adapted mesh, number of elements: "
+  << triangulation.n_global_active_cells()
+  << std::endl
+  << "number of degrees of freedom: "
+  << dofHandler.n_dofs()
+  << std::endl;
+
+  computing_timer.exit_section("adaptive refinement");
+}
+#include "../../include/ellipticBVP_template_instantiations.h"
@@ -7,7 +7,7 @@ void ellipticBVP<dim>::assemble(){
 
   //local variables
   QGauss<dim>  quadrature(userInputs.quadOrder);
-  FEValues<dim> fe_values (FE, quadrature, update_values | update_gradients | update_JxW_values);
+  FEValues<dim> fe_values (getMapping(), FE, quadrature, update_values | update_gradients | update_JxW_values);
   const unsigned int   dofs_per_cell   = FE.dofs_per_cell;
   const unsigned int   num_quad_points = quadrature.size();
   FullMatrix<double>   elementalJacobian (dofs_per_cell, dofs_per_cell);
@@ -17,15 +17,6 @@ void ellipticBVP<dim>::assemble(){
   //apply Dirichlet BC's
   applyDirichletBCs();
 
-  if(userInputs.enablePeriodicBCs){
-    DynamicSparsityPattern dsp (locally_relevant_dofs_Mod);
-    DoFTools::make_sparsity_pattern (dofHandler, dsp, constraints, false);
-    SparsityTools::distribute_sparsity_pattern (dsp,
-      dofHandler.n_locally_owned_dofs_per_processor(),
-      mpi_communicator,
-      locally_relevant_dofs_Mod);
-      jacobian.reinit (locally_owned_dofs, locally_owned_dofs, dsp, mpi_communicator);
-    }
   //initialize global data structures to zero
   //The additional compress operations are only to flush out data and
   //switch to the correct write state. For  details look at the documentation
@@ -49,7 +40,14 @@ void ellipticBVP<dim>::assemble(){
         fe_values.reinit (cell);
         cell->get_dof_indices (local_dof_indices);
         //get elemental jacobian and residual
-        getElementalValues(fe_values, dofs_per_cell, num_quad_points, elementalJacobian, elementalResidual);
+        if (userInputs.enableCostWeightedRepartition){
+          double cellStartTime=MPI_Wtime();
+          getElementalValues(fe_values, dofs_per_cell, num_quad_points, elementalJacobian, elementalResidual);
+          cellCost[cellID]+=MPI_Wtime()-cellStartTime;
+        }
+        else{
+          getElementalValues(fe_values, dofs_per_cell, num_quad_points, elementalJacobian, elementalResidual);
+        }
         //
         constraints.distribute_local_to_global(elementalJacobian,
           elementalResidual,
@@ -13,7 +13,7 @@ void ellipticBVP<dim>::assemble2(){
 
   //local variables
   QGauss<dim>  quadrature(userInputs.quadOrder);
-  FEValues<dim> fe_values (FE, quadrature, update_values | update_gradients | update_JxW_values);
+  FEValues<dim> fe_values (getMapping(), FE, quadrature, update_values | update_gradients | update_JxW_values);
   const unsigned int   dofs_per_cell   = FE.dofs_per_cell;
   const unsigned int   num_quad_points = quadrature.size();
   Vector<double>       elementalResidual (dofs_per_cell);
@@ -35,7 +35,14 @@ void ellipticBVP<dim>::assemble2(){
         fe_values.reinit (cell);
         cell->get_dof_indices (local_dof_indices);
         //get elemental jacobian and residual
-        getElementalValues2(fe_values, dofs_per_cell, num_quad_points, elementalResidual);
+        if (userInputs.enableCostWeightedRepartition){
+          double cellStartTime=MPI_Wtime();
+          getElementalValues2(fe_values, dofs_per_cell, num_quad_points, elementalResidual);
+          cellCost[cellID]+=MPI_Wtime()-cellStartTime;
+        }
+        else{
+          getElementalValues2(fe_values, dofs_per_cell, num_quad_points, elementalResidual);
+        }
         //
         constraints.distribute_local_to_global(elementalResidual,
           local_dof_indices,
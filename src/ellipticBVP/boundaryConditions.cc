@@ -1,465 +1,322 @@
 //methods to apply Dirichlet boundary conditons
 #include "../../include/ellipticBVP.h"
 
-//Specify Dirichlet boundary conditions
+//Check if a node lies on one of the 2*dim faces of the box
+//(faces are ordered x=0, x=span[0], y=0, y=span[1], z=0, z=span[2])
 template <int dim>
-void ellipticBVP<dim>::setBoundaryValues(const Point<dim>& node, const unsigned int dof, bool& flag, double& value){
-  unsigned int i ;
+bool ellipticBVP<dim>::nodeOnFace(const Point<dim>& node, const unsigned int face){
+  const unsigned int i=face/2;
+  if (face%2==0)
+  return (node[i] <= externalMeshParameterBCs(i));
+  else
+  return (node[i] >= (userInputs.span[i]-externalMeshParameterBCs(i)));
+}
 
-  Vector<double> externalMeshParameterBCs(dim);
-  for (unsigned int i=0; i<dim; ++i) {
-    externalMeshParameterBCs(i)=userInputs.externalMeshParameter*userInputs.span[i];
-  }
+//Find which boundary condition (and on which face) constrains a given DOF.
+//The order of the checks sets the precedence between the different types of BCs.
+template <int dim>
+void ellipticBVP<dim>::getBoundaryType(const Point<dim>& node, const unsigned int dof, bool& flag, unsigned int& bcType, unsigned int& face){
+  flag=false;
 
   if(userInputs.enableCyclicLoading){
-    if(dof==(userInputs.cyclicLoadingDOF-1)){
-      switch (userInputs.cyclicLoadingFace){
-        case 1:
-        if (node[0] <= externalMeshParameterBCs(0))
-        {
-          if(fmod((currentIncrement*delT),cycleTime)<userInputs.quarterCycleTime){
-            flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else if(fmod((currentIncrement*delT),cycleTime)<3*userInputs.quarterCycleTime){
-            flag=true; value=-deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else{flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-	}
-      	break;
-
-        case 2:
-        if (node[0] >= (userInputs.span[0]-externalMeshParameterBCs(0)))
-        {
-          //pcout<<"Positive12"<<std::endl;
-          if(fmod((currentIncrement*delT),cycleTime)<userInputs.quarterCycleTime){
-            //pcout<<"Positive"<<std::endl;
-            flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else if(fmod((currentIncrement*delT),cycleTime)<3*userInputs.quarterCycleTime){
-            //pcout<<"negative"<<std::endl;
-            flag=true; value=-deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else{//pcout<<"Positive12"<<std::endl;
-          flag=true;value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-        }
-        break;
-        case 3:
-        if (node[1] <= externalMeshParameterBCs(1))
-          if(fmod((currentIncrement*delT),cycleTime)<userInputs.quarterCycleTime){
-            flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else if(fmod((currentIncrement*delT),cycleTime)<3*userInputs.quarterCycleTime){
-            flag=true; value=-deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else{flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-        break;
-        case 4:
-        if (node[1] >= (userInputs.span[1]-externalMeshParameterBCs(1)))
-          if(fmod((currentIncrement*delT),cycleTime)<userInputs.quarterCycleTime){
-            flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else if(fmod((currentIncrement*delT),cycleTime)<3*userInputs.quarterCycleTime){
-            flag=true; value=-deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else{flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-        break;
-        case 5:
-        if (node[2] <= externalMeshParameterBCs(2))
-          if(fmod((currentIncrement*delT),cycleTime)<userInputs.quarterCycleTime){
-            flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else if(fmod((currentIncrement*delT),cycleTime)<3*userInputs.quarterCycleTime){
-            flag=true; value=-deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else{flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-        break;
-        case 6:
-        if (node[2] >= (userInputs.span[2]-externalMeshParameterBCs(2)))
-          if(fmod((currentIncrement*delT),cycleTime)<userInputs.quarterCycleTime){
-            flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else if(fmod((currentIncrement*delT),cycleTime)<3*userInputs.quarterCycleTime){
-            flag=true; value=-deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-          else{flag=true; value=deluConstraint[userInputs.cyclicLoadingFace-1][dof];return;}
-      }
+    if((dof==(userInputs.cyclicLoadingDOF-1))&&(nodeOnFace(node,userInputs.cyclicLoadingFace-1))){
+      flag=true; bcType=cyclicBC; face=userInputs.cyclicLoadingFace-1; return;
     }
   }
 
   if((userInputs.enableSimpleBCs)||(userInputs.enableCyclicLoading)){
-    for (i=0;i<2*dim;i++){
-      if(faceDOFConstrained[i][dof])
-        switch (i+1){
-          case 1:
-          if (node[0] <= externalMeshParameterBCs(0))
-              {//pcout<<i<<" "<<dof<<std::endl;
-                flag=true; value=deluConstraint[i][dof];return;}
-          break;
-          case 2:
-          if (node[0] >= (userInputs.span[0]-externalMeshParameterBCs(0)))
-              {//pcout<<i<<" "<<dof<<std::endl;
-                flag=true; value=deluConstraint[i][dof];return;}
-          break;
-          case 3:
-          if (node[1] <= externalMeshParameterBCs(1))
-              {//pcout<<i<<" "<<dof<<std::endl;
-                flag=true; value=deluConstraint[i][dof];return;}
-          break;
-          case 4:
-          if (node[1] >= (userInputs.span[1]-externalMeshParameterBCs(1)))
-              {//pcout<<i<<" "<<dof<<std::endl;
-                flag=true; value=deluConstraint[i][dof];return;}
-          break;
-          case 5:
-          if (node[2] <= externalMeshParameterBCs(2))
-              {//pcout<<i<<" "<<dof<<std::endl;
-                flag=true; value=deluConstraint[i][dof];return;}
-          break;
-          case 6:
-          if (node[2] >= (userInputs.span[2]-externalMeshParameterBCs(2)))
-              {//pcout<<i<<" "<<dof<<std::endl;
-                flag=true; value=deluConstraint[i][dof];return;}
-        }
+    for (unsigned int i=0;i<2*dim;i++){
+      if((faceDOFConstrained[i][dof])&&(nodeOnFace(node,i))){
+        flag=true; bcType=simpleBC; face=i; return;
+      }
     }
   }
 
   if(userInputs.enableTabularBCs){
-
-    for (i=0;i<2*dim;i++){
-      if(faceDOFConstrained[i][dof])
-        switch (i+1){
-          case 1:
-          if (node[0] <= externalMeshParameterBCs(0))
-              {//pcout<<i<<" "<<dof<<std::endl;
-                flag=true;
-
-                currentTime=delT*(currentIncrement+1);
-
-                if (currentIncrement==0){
-                  timeCounter=1;
-                }
-                if (currentTime>userInputs.tabularTimeInput[timeCounter]){
-                  timeCounter=timeCounter+1;
-                }
-
-                value=(-tabularDisplacements[3*i+dof][timeCounter-1]+tabularDisplacements[3*i+dof][timeCounter])/(userInputs.tabularTimeInput[timeCounter]-userInputs.tabularTimeInput[timeCounter-1])*delT ;
-
-                return;}
-          break;
-          case 2:
-          if (node[0] >= (userInputs.span[0]-externalMeshParameterBCs(0)))
-              {//pcout<<i<<" "<<dof<<std::endl;
-              flag=true;
-
-              currentTime=delT*(currentIncrement+1);
-
-              if (currentIncrement==0){
-                timeCounter=1;
-              }
-              if (currentTime>userInputs.tabularTimeInput[timeCounter]){
-                timeCounter=timeCounter+1;
-              }
-
-              value=(-tabularDisplacements[3*i+dof][timeCounter-1]+tabularDisplacements[3*i+dof][timeCounter])/(userInputs.tabularTimeInput[timeCounter]-userInputs.tabularTimeInput[timeCounter-1])*delT ;
-
-              return;}
-          break;
-          case 3:
-          if (node[1] <= externalMeshParameterBCs(1))
-              {//pcout<<i<<" "<<dof<<std::endl;
-              flag=true;
-
-              currentTime=delT*(currentIncrement+1);
-
-              if (currentIncrement==0){
-                timeCounter=1;
-              }
-              if (currentTime>userInputs.tabularTimeInput[timeCounter]){
-                timeCounter=timeCounter+1;
-              }
-
-              value=(-tabularDisplacements[3*i+dof][timeCounter-1]+tabularDisplacements[3*i+dof][timeCounter])/(userInputs.tabularTimeInput[timeCounter]-userInputs.tabularTimeInput[timeCounter-1])*delT ;
-
-              return;}
-          break;
-          case 4:
-          if (node[1] >= (userInputs.span[1]-externalMeshParameterBCs(1)))
-              {//pcout<<i<<" "<<dof<<std::endl;
-              flag=true;
-
-              currentTime=delT*(currentIncrement+1);
-
-              if (currentIncrement==0){
-                timeCounter=1;
-              }
-              if (currentTime>userInputs.tabularTimeInput[timeCounter]){
-                timeCounter=timeCounter+1;
-              }
-
-              value=(-tabularDisplacements[3*i+dof][timeCounter-1]+tabularDisplacements[3*i+dof][timeCounter])/(userInputs.tabularTimeInput[timeCounter]-userInputs.tabularTimeInput[timeCounter-1])*delT ;
-
-              return;}
-          break;
-          case 5:
-          if (node[2] <= externalMeshParameterBCs(2))
-              {//pcout<<i<<" "<<dof<<std::endl;
-              flag=true;
-
-              currentTime=delT*(currentIncrement+1);
-
-              if (currentIncrement==0){
-                timeCounter=1;
-              }
-              if (currentTime>userInputs.tabularTimeInput[timeCounter]){
-                timeCounter=timeCounter+1;
-              }
-
-              value=(-tabularDisplacements[3*i+dof][timeCounter-1]+tabularDisplacements[3*i+dof][timeCounter])/(userInputs.tabularTimeInput[timeCounter]-userInputs.tabularTimeInput[timeCounter-1])*delT ;
-
-              return;}
-          break;
-          case 6:
-          if (node[2] >= (userInputs.span[2]-externalMeshParameterBCs(2)))
-              {//pcout<<i<<" "<<dof<<std::endl;
-              flag=true;
-
-              currentTime=delT*(currentIncrement+1);
-
-              if (currentIncrement==0){
-                timeCounter=1;
-              }
-              if (currentTime>userInputs.tabularTimeInput[timeCounter]){
-                timeCounter=timeCounter+1;
-              }
-
-              value=(-tabularDisplacements[3*i+dof][timeCounter-1]+tabularDisplacements[3*i+dof][timeCounter])/(userInputs.tabularTimeInput[timeCounter]-userInputs.tabularTimeInput[timeCounter-1])*delT ;
-
-              return;}
-        }
+    for (unsigned int i=0;i<2*dim;i++){
+      if((faceDOFConstrained[i][dof])&&(nodeOnFace(node,i))){
+        flag=true; bcType=tabularBC; face=i; return;
+      }
     }
   }
 
   if(userInputs.useVelocityGrad){
-    value = 0;
-    for(i=0;i<dim;i++)
-      value+=deltaF[dof][i]*node[i];
-    flag=true;
-    return;
+    flag=true; bcType=velocityGradientBC; face=0; return;
   }
 
   if(userInputs.enableDICpipeline){
-
-  //back boundary
-  if (node[0] <= externalMeshParameterBCs(0)){
-    double value_x, value_y;
-    bcFunction1(node[1],value_x,value_y, currentIncrement);
-    if (dof==0) {flag=true; value=value_x;}
-    if (dof==1) {flag=true; value=value_y;}
+    //x and y displacements are prescribed on the four lateral faces, the last matching face wins
+    if (dof<2){
+      for (unsigned int i=0;i<4;i++){
+        if (nodeOnFace(node,i)){
+          flag=true; bcType=dicBC; face=i;
+        }
+      }
+    }
+    //bottom boundary: u_z=0 at the corner
+    if ((dof==2)&&(nodeOnFace(node,4))&&(nodeOnFace(node,0))&&(nodeOnFace(node,2))){
+      flag=true; bcType=dicBC; face=4;
+    }
   }
+}
 
-
-  //front boundary
-  if (node[0] >= (userInputs.span[0]-externalMeshParameterBCs(0))){
-    double value_x, value_y;
-    bcFunction2(node[1],value_x,value_y, currentIncrement);
-    if (dof==0) {flag=true; value=value_x;}
-    if (dof==1) {flag=true; value=value_y;}
+//Boundary value increment of a DOF for the current increment
+template <int dim>
+double ellipticBVP<dim>::getBoundaryValue(const Point<dim>& node, const unsigned int dof, const unsigned int bcType, const unsigned int face){
+  double value=0.0;
+  switch (bcType){
+    case cyclicBC:
+    if(fmod((currentIncrement*delT),cycleTime)<userInputs.quarterCycleTime)
+    value=deluConstraint[face][dof];
+    else if(fmod((currentIncrement*delT),cycleTime)<3*userInputs.quarterCycleTime)
+    value=-deluConstraint[face][dof];
+    else
+    value=deluConstraint[face][dof];
+    break;
+
+    case simpleBC:
+    value=deluConstraint[face][dof];
+    break;
+
+    case tabularBC:
+    value=(-tabularDisplacements[3*face+dof][timeCounter-1]+tabularDisplacements[3*face+dof][timeCounter])/(userInputs.tabularTimeInput[timeCounter]-userInputs.tabularTimeInput[timeCounter-1])*delT ;
+    break;
+
+    case velocityGradientBC:
+    for(unsigned int i=0;i<dim;i++)
+    value+=deltaF[dof][i]*node[i];
+    break;
+
+    case dicBC:
+    if (face<4){
+      unsigned int index;
+      double weight;
+      findDICSamples(face, (face<2)?node[1]:node[0], index, weight);
+      value=getDICValue(face, dof, index, weight);
+    }
+    break;
   }
+  return value;
+}
 
-
-  //left boundary
-  if (node[1] <= externalMeshParameterBCs(1)){
-    double value_x, value_y;
-    bcFunction3(node[0],value_x,value_y, currentIncrement);
-    if (dof==0) {flag=true; value=value_x;}
-    if (dof==1) {flag=true; value=value_y;}
-
+//Specify Dirichlet boundary conditions
+template <int dim>
+void ellipticBVP<dim>::setBoundaryValues(const Point<dim>& node, const unsigned int dof, bool& flag, double& value){
+  unsigned int bcType, face;
+  getBoundaryType(node, dof, flag, bcType, face);
+  if (flag){
+    value=getBoundaryValue(node, dof, bcType, face);
   }
+}
 
-  //left boundary
-  if (node[1] >= (userInputs.span[1]-externalMeshParameterBCs(1))){
-    double value_x, value_y;
-    bcFunction4(node[0],value_x,value_y, currentIncrement);
-    if (dof==0) {flag=true; value=value_x;}
-    if (dof==1) {flag=true; value=value_y;}
-
+//Build the list of constrained boundary DOFs (with their BC type, face and
+//support point) once, so that applyDirichletBCs() does not need to loop over the mesh.
+template <int dim>
+void ellipticBVP<dim>::initDirichletBCs(){
+  externalMeshParameterBCs.reinit(dim);
+  for (unsigned int i=0; i<dim; ++i) {
+    externalMeshParameterBCs(i)=userInputs.externalMeshParameter*userInputs.span[i];
   }
 
-
-  //bottom boundary: u_z=0
-  if (node[2] <= externalMeshParameterBCs(2)){
-    if(node[0]<= externalMeshParameterBCs(0) && node[1] <= externalMeshParameterBCs(1)){
-      if (dof==2) {flag=true; value=0.0;}
+  dirichletDOFs.clear(); dirichletDOFComponents.clear(); dirichletDOFTypes.clear(); dirichletDOFFaces.clear(); dirichletDOFNodes.clear();
+  dirichletDICIndex.clear(); dirichletDICWeight.clear();
+  if(userInputs.enablePeriodicBCs) return;
+
+  //hanging node constraints are built first, so that hanging boundary DOFs (which follow
+  //their constrained parent DOFs) are not constrained a second time
+  constraints.clear();
+  constraints.reinit (locally_relevant_dofs);
+  DoFTools::make_hanging_node_constraints (dofHandler, constraints);
+
+  const unsigned int dofs_per_face = FE.dofs_per_face;
+  std::vector<types::global_dof_index> face_dof_indices (dofs_per_face);
+  std::set<types::global_dof_index> visitedDOFs;
+
+  typename DoFHandler<dim>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
+  for (; cell!=endc; ++cell) {
+    if (cell->is_locally_owned()){
+      for (unsigned int faceID=0; faceID<GeometryInfo<dim>::faces_per_cell; faceID++){
+        if (cell->face(faceID)->at_boundary()){
+          cell->face(faceID)->get_dof_indices (face_dof_indices);
+          for (unsigned int i=0; i<dofs_per_face; ++i) {
+            const types::global_dof_index globalDOF=face_dof_indices[i];
+            if (!visitedDOFs.insert(globalDOF).second) continue;
+            if (constraints.is_constrained(globalDOF)) continue;
+            const unsigned int dof = FE.face_system_to_component_index(i).first;
+            const Point<dim> dofNode=supportPoints[globalDOF];
+            bool flag;
+            unsigned int bcType, face;
+            getBoundaryType(dofNode, dof, flag, bcType, face);
+            if (flag){
+              dirichletDOFs.push_back(globalDOF);
+              dirichletDOFComponents.push_back(dof);
+              dirichletDOFTypes.push_back(bcType);
+              dirichletDOFFaces.push_back(face);
+              dirichletDOFNodes.push_back(dofNode);
+              //DIC samples are located once per boundary node
+              unsigned int dicIndex=0;
+              double dicWeight=1.0;
+              if ((bcType==dicBC)&&(face<4)){
+                findDICSamples(face, (face<2)?dofNode[1]:dofNode[0], dicIndex, dicWeight);
+              }
+              dirichletDICIndex.push_back(dicIndex);
+              dirichletDICWeight.push_back(dicWeight);
+            }
+          }
+        }
+      }
     }
   }
-  }
 
+  //The constraint structure (hanging nodes and boundary DOFs) does not change between
+  //increments, so it is built and closed once here and applyDirichletBCs() only updates the
+  //inhomogeneities. If hanging node constraints exist, close() folds the boundary values into
+  //them, so in that case the constraints are rebuilt in every call of applyDirichletBCs().
+  reuseDirichletConstraints=(Utilities::MPI::max(constraints.n_constraints(),mpi_communicator)==0);
+  for (unsigned int i=0; i<dirichletDOFs.size(); ++i) {
+    constraints.add_line (dirichletDOFs[i]);
+  }
+  constraints.close ();
 }
 
-
+//Reorganize the DIC input (bc_new1..bc_new4) for the evaluation of the boundary values.
+//For each lateral face the sample coordinates are sorted, and the displacement rates of
+//each time interval are stored contiguously as (x,y) pairs of the sorted samples.
 template <int dim>
-void ellipticBVP<dim>::bcFunction1(double yval, double &value_x, double &value_y, double currentIncr){
-
-  unsigned int n_div=userInputs.Y_dic;
-  std::vector<double> coord(n_div);
-
-  for (unsigned int i=0; i<(n_div); i++){
-    coord[i]=fabs(yval-bc_new1[i][0]);
-  }
-
-  std::vector<double>::iterator result;
-  result = std::min_element(coord.begin(), coord.end());
-  int coord_pos;
-  coord_pos= std::distance(coord.begin(), result);
-
-  currentTime=delT*(currentIncrement+1);
-
-  if (currentIncrement==0){
-    timeCounter=1;
-  }
-  if (currentTime>userInputs.timeInputDIC[timeCounter]){
-    timeCounter=timeCounter+1;
+void ellipticBVP<dim>::initDICBCs(){
+  const unsigned int numIntervals=userInputs.DIC_InputStepNumber-1;
+  dicCoords.resize(4);
+  dicRates.resize(4);
+
+  for (unsigned int face=0; face<4; face++){
+    FullMatrix<double> &bc_new=(face==0)?bc_new1:(face==1)?bc_new2:(face==2)?bc_new3:bc_new4;
+    const unsigned int n_div=(face<2)?userInputs.Y_dic:userInputs.X_dic;
+
+    std::vector<unsigned int> order(n_div);
+    for (unsigned int i=0; i<n_div; i++) order[i]=i;
+    std::stable_sort(order.begin(), order.end(), [&bc_new](unsigned int i1, unsigned int i2){return bc_new[i1][0]<bc_new[i2][0];});
+
+    dicCoords[face].resize(n_div);
+    dicRates[face].resize(numIntervals*n_div*2);
+    for (unsigned int i=0; i<n_div; i++){
+      dicCoords[face][i]=bc_new[order[i]][0];
+      for (unsigned int t=1; t<=numIntervals; t++){
+        const double invDt=1.0/(userInputs.timeInputDIC[t]-userInputs.timeInputDIC[t-1]);
+        dicRates[face][((t-1)*n_div+i)*2]=(-bc_new[order[i]][1+(t-1)*2]+bc_new[order[i]][1+t*2])*invDt;
+        dicRates[face][((t-1)*n_div+i)*2+1]=(-bc_new[order[i]][2+(t-1)*2]+bc_new[order[i]][2+t*2])*invDt;
+      }
+    }
   }
-
-  value_x=(-bc_new1[coord_pos][1+(timeCounter-1)*2]+bc_new1[coord_pos][1+timeCounter*2])/(userInputs.timeInputDIC[timeCounter]-userInputs.timeInputDIC[timeCounter-1])*delT ;
-  value_y=(-bc_new1[coord_pos][2+(timeCounter-1)*2]+bc_new1[coord_pos][2+timeCounter*2])/(userInputs.timeInputDIC[timeCounter]-userInputs.timeInputDIC[timeCounter-1])*delT ;
-  //return value1 ; // displacement along X-Direction
-
 }
 
+//Find the DIC sample(s) used for a boundary node at coordinate coord along the face.
+//The value is weight*sample[index]+(1-weight)*sample[index+1]; for the nearest
+//sample (default) weight is 1.
 template <int dim>
-void ellipticBVP<dim>::bcFunction2(double yval, double &value_x, double &value_y,double currentIncr){
-
-  unsigned int n_div=userInputs.Y_dic;
-  std::vector<double> coord(n_div);
-
-  for (unsigned int i=0; i<(n_div); i++){
-    coord[i]=fabs(yval-bc_new2[i][0]);
+void ellipticBVP<dim>::findDICSamples(const unsigned int face, const double coord, unsigned int& index, double& weight){
+  const std::vector<double> &coords=dicCoords[face];
+  const unsigned int n_div=coords.size();
+  std::vector<double>::const_iterator upper=std::upper_bound(coords.begin(), coords.end(), coord);
+  unsigned int i2=std::distance(coords.begin(), upper);
+
+  if (i2==0){
+    index=0; weight=1.0; return;
+  }
+  if (i2==n_div){
+    index=n_div-1; weight=1.0; return;
   }
 
-  std::vector<double>::iterator result;
-  result = std::min_element(coord.begin(), coord.end());
-  int coord_pos;
-  coord_pos= std::distance(coord.begin(), result);
-
-  currentTime=delT*(currentIncrement+1);
-
-  if (currentIncrement==0){
-    timeCounter=1;
+  const unsigned int i1=i2-1;
+  const double t=(coord-coords[i1])/(coords[i2]-coords[i1]);
+  if (userInputs.enableDICLinearInterpolation){
+    index=i1; weight=1.0-t;
   }
-  if (currentTime>userInputs.timeInputDIC[timeCounter]){
-    timeCounter=timeCounter+1;
+  else{
+    index=(t<=0.5)?i1:i2; weight=1.0;
   }
-
-  value_x=(-bc_new2[coord_pos][1+(timeCounter-1)*2]+bc_new2[coord_pos][1+timeCounter*2])/(userInputs.timeInputDIC[timeCounter]-userInputs.timeInputDIC[timeCounter-1])*delT ;
-  value_y=(-bc_new2[coord_pos][2+(timeCounter-1)*2]+bc_new2[coord_pos][2+timeCounter*2])/(userInputs.timeInputDIC[timeCounter]-userInputs.timeInputDIC[timeCounter-1])*delT ;
-
-
-
-  //return value1 ; // displacement along X-Direction
-
 }
 
+//Displacement increment of component dof (0: x, 1: y) from the DIC data of a face
 template <int dim>
-void ellipticBVP<dim>::bcFunction3(double xval, double &value_x, double &value_y,double currentIncr){
-
-  unsigned int n_div=userInputs.X_dic;
-  std::vector<double> coord(n_div);
-
-  for (unsigned int i=0; i<(n_div); i++){
-    coord[i]=fabs(xval-bc_new3[i][0]);
-  }
-
-  std::vector<double>::iterator result;
-  result = std::min_element(coord.begin(), coord.end());
-  int coord_pos;
-  coord_pos= std::distance(coord.begin(), result);
-
-  currentTime=delT*(currentIncrement+1);
-
-  if (currentIncrement==0){
-    timeCounter=1;
-  }
-  if (currentTime>userInputs.timeInputDIC[timeCounter]){
-    timeCounter=timeCounter+1;
+double ellipticBVP<dim>::getDICValue(const unsigned int face, const unsigned int dof, const unsigned int index, const double weight){
+  const unsigned int n_div=dicCoords[face].size();
+  const double *rates=&dicRates[face][((timeCounter-1)*n_div+index)*2+dof];
+  double value=weight*rates[0];
+  if (weight<1.0){
+    value+=(1.0-weight)*rates[2];
   }
-
-  value_x=(-bc_new3[coord_pos][1+(timeCounter-1)*2]+bc_new3[coord_pos][1+timeCounter*2])/(userInputs.timeInputDIC[timeCounter]-userInputs.timeInputDIC[timeCounter-1])*delT ;
-  value_y=(-bc_new3[coord_pos][2+(timeCounter-1)*2]+bc_new3[coord_pos][2+timeCounter*2])/(userInputs.timeInputDIC[timeCounter]-userInputs.timeInputDIC[timeCounter-1])*delT ;
-
-
+  return value*delT;
 }
 
+//Advance timeCounter so that the current time lies in (timeTable[timeCounter-1],timeTable[timeCounter]]
 template <int dim>
-void ellipticBVP<dim>::bcFunction4(double xval, double &value_x, double &value_y,double currentIncr){
-
-  unsigned int n_div=userInputs.X_dic;
-  std::vector<double> coord(n_div);
-
-  for (unsigned int i=0; i<(n_div); i++){
-    coord[i]=fabs(xval-bc_new4[i][0]);
-  }
-
-  std::vector<double>::iterator result;
-  result = std::min_element(coord.begin(), coord.end());
-  int coord_pos;
-  coord_pos= std::distance(coord.begin(), result);
+void ellipticBVP<dim>::advanceTimeCounter(const std::vector<double>& timeTable){
   currentTime=delT*(currentIncrement+1);
-
   if (currentIncrement==0){
     timeCounter=1;
   }
-  if (currentTime>userInputs.timeInputDIC[timeCounter]){
+  while ((timeCounter<timeTable.size()-1)&&(currentTime>timeTable[timeCounter])){
     timeCounter=timeCounter+1;
   }
-
-  value_x=(-bc_new4[coord_pos][1+(timeCounter-1)*2]+bc_new4[coord_pos][1+timeCounter*2])/(userInputs.timeInputDIC[timeCounter]-userInputs.timeInputDIC[timeCounter-1])*delT ;
-  value_y=(-bc_new4[coord_pos][2+(timeCounter-1)*2]+bc_new4[coord_pos][2+timeCounter*2])/(userInputs.timeInputDIC[timeCounter]-userInputs.timeInputDIC[timeCounter-1])*delT ;
-
-
 }
 
 
-
 //methods to apply dirichlet BC's
 template <int dim>
 void ellipticBVP<dim>::applyDirichletBCs(){
+  //restore the inhomogeneities changed for the predictor in the first iteration
+  for (unsigned int i=0; i<predictorConstraintLines.size(); ++i){
+    if (constraints.is_constrained(predictorConstraintLines[i].first)){
+      constraints.set_inhomogeneity(predictorConstraintLines[i].first, predictorConstraintLines[i].second);
+    }
+  }
+  predictorConstraintLines.clear();
 
   if(!userInputs.enablePeriodicBCs){
-    constraints.clear();
-    constraints.reinit (locally_relevant_dofs);
-    DoFTools::make_hanging_node_constraints (dofHandler, constraints);
-    const unsigned int   dofs_per_cell   = FE.dofs_per_cell;
-    std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
-    FEValues<dim> fe_values (FE, QGauss<dim>(userInputs.quadOrder), update_values);
-    FEFaceValues<dim> fe_face_values (FE, QGauss<dim-1>(userInputs.quadOrder), update_values);
-
-    //parallel loop over all elements
-    typename DoFHandler<dim>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
-    for (; cell!=endc; ++cell) {
-      if (cell->is_locally_owned()){
-        cell->get_dof_indices (local_dof_indices);
-        fe_values.reinit (cell);
-        for (unsigned int faceID=0; faceID<GeometryInfo<dim>::faces_per_cell; faceID++){
-          if (cell->face(faceID)->at_boundary()){
-            fe_face_values.reinit (cell, faceID);
-            for (unsigned int i=0; i<dofs_per_cell; ++i) {
-              if (fe_face_values.shape_value(i, 0)!=0){
-                const unsigned int dof = fe_values.get_fe().system_to_component_index(i).first;
-                unsigned int globalDOF=local_dof_indices[i];
-                bool flag=false;
-                double value=0;
-                node=supportPoints[globalDOF];
-                setBoundaryValues(node, dof, flag, value);
-                if (flag){
-                  constraints.add_line (globalDOF);
-                  if (currentIteration==0){
-                    value*=loadFactorSetByModel;
-                  }
-                  else{
-                    value=0.0;
-                  }
-                  constraints.set_inhomogeneity(globalDOF, value);
-                }
-              }
-            }
-          }
+    if (!reuseDirichletConstraints){
+      constraints.clear();
+      constraints.reinit (locally_relevant_dofs);
+      DoFTools::make_hanging_node_constraints (dofHandler, constraints);
+    }
+
+    if (currentIteration==0){
+      if (userInputs.enableTabularBCs){
+        advanceTimeCounter(userInputs.tabularTimeInput);
+      }
+      if (userInputs.enableDICpipeline){
+        advanceTimeCounter(userInputs.timeInputDIC);
+      }
+    }
+
+    //loop over the precomputed boundary DOFs, only the first iteration of an increment
+    //has a nonzero boundary value
+    for (unsigned int i=0; i<dirichletDOFs.size(); ++i) {
+      double value=0.0;
+      if (currentIteration==0){
+        if ((dirichletDOFTypes[i]==dicBC)&&(dirichletDOFFaces[i]<4)){
+          value=getDICValue(dirichletDOFFaces[i], dirichletDOFComponents[i], dirichletDICIndex[i], dirichletDICWeight[i]);
         }
+        else{
+          value=getBoundaryValue(dirichletDOFNodes[i], dirichletDOFComponents[i], dirichletDOFTypes[i], dirichletDOFFaces[i]);
+        }
+        value*=loadFactorSetByModel;
+      }
+      if (!reuseDirichletConstraints){
+        constraints.add_line (dirichletDOFs[i]);
       }
+      constraints.set_inhomogeneity(dirichletDOFs[i], value);
+    }
+
+    if (!reuseDirichletConstraints){
+      constraints.close ();
     }
   }
   else{
     setPeriodicityConstraints();
   }
 
-  constraints.close ();
+  if ((currentIteration==0)&&(solutionPredicted)){
+    applyPredictionToConstraints();
+  }
 }
 #include "../../include/ellipticBVP_template_instantiations.h"
@@ -0,0 +1,57 @@
+//uniform mesh detection method for ellipticBVP class
+#include "../../include/ellipticBVP.h"
+
+//check whether all cells are identical axis-aligned bricks (e.g. the subdivided_hyper_rectangle mesh).
+//On all axis-aligned meshes (also with cells of different sizes, e.g. the grain interior coarsened
+//voxel mesh) FEValues uses MappingCartesian, which avoids the general Jacobian computation of MappingQ1.
+//On uniform meshes the shape gradients and JxW of the first cell are used for all cells in
+//updateAfterIncrement(), and the projection reuses one elemental mass matrix and N*JxW table.
+//The assembly still calls FEValues::reinit for every cell, as the material model reads the
+//current cell from the FEValues object.
+template <int dim>
+void ellipticBVP<dim>::checkUniformCartesianMesh(){
+  bool isCartesian=true;
+  std::vector<double> minCellSize(dim,std::numeric_limits<double>::max()), maxCellSize(dim,0.0);
+
+  typename DoFHandler<dim>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
+  for (; (cell!=endc)&&isCartesian; ++cell) {
+    if (cell->is_locally_owned()){
+      const Point<dim> origin=cell->vertex(0);
+      Point<dim> cellSize;
+      for (unsigned int d=0; d<dim; d++){
+        cellSize[d]=cell->vertex(1<<d)[d]-origin[d];
+        minCellSize[d]=std::min(minCellSize[d],cellSize[d]);
+        maxCellSize[d]=std::max(maxCellSize[d],cellSize[d]);
+      }
+      //vertex v of an axis-aligned brick is at origin+sum_d bit_d(v)*cellSize_d
+      const double tol=1.0e-10*cellSize.norm();
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; v++){
+        for (unsigned int d=0; d<dim; d++){
+          const double expected=origin[d]+((v>>d)&1)*cellSize[d];
+          if (std::abs(cell->vertex(v)[d]-expected)>tol) isCartesian=false;
+        }
+      }
+    }
+  }
+
+  isCartesian=(Utilities::MPI::min((unsigned int)isCartesian, mpi_communicator)==1);
+  bool isUniform=isCartesian;
+  for (unsigned int d=0; d<dim; d++){
+    const double globalMin=Utilities::MPI::min(minCellSize[d], mpi_communicator);
+    const double globalMax=Utilities::MPI::max(maxCellSize[d], mpi_communicator);
+    if ((globalMin<=0.0)||(globalMax-globalMin>1.0e-10*globalMax)) isUniform=false;
+  }
+
+  cartesianMesh=isCartesian;
+  uniformCartesianMesh=isUniform;
+  if (uniformCartesianMesh) pcout << "uniform Cartesian mesh detected, using the Cartesian mapping\n";
+  else if (cartesianMesh) pcout << "Cartesian mesh detected, using the Cartesian mapping\n";
+}
+
+//mapping used for all FEValues objects
+template <int dim>
+const Mapping<dim>& ellipticBVP<dim>::getMapping() const{
+  if (cartesianMesh) return mappingCartesian;
+  return mappingQ1;
+}
+#include "../../include/ellipticBVP_template_instantiations.h"
@@ -21,7 +21,12 @@ ellipticBVP<dim>::ellipticBVP (userInputParameters _userInputs):
   currentIncrement(0),
   resetIncrement(false),
   loadFactorSetByModel(1.0),
+  localToleranceFactor(1.0),
   totalLoadFactor(0.0),
+  previousLoadFactor(0.0),
+  solutionPredicted(false),
+  cartesianMesh(false),
+  uniformCartesianMesh(false),
   pcout (std::cout, Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0),
   computing_timer (pcout, TimerOutput::summary, TimerOutput::wall_times),
   numPostProcessedFields(0)
@@ -36,6 +41,9 @@ ellipticBVP<dim>::ellipticBVP (userInputParameters _userInputs):
   totalIncrements=totalT/delT;
   if(userInputs.enableTabularPeriodicBCs)
     periodicTotalIncrements=userInputs.periodicTabularTime/delT;
+
+  //threads of this MPI process used by the thread-parallel cell loops
+  MultithreadInfo::set_thread_limit(userInputs.numThreadsPerProcess);
 }
 
 //destructor
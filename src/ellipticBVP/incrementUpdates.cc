@@ -13,4 +13,40 @@ void ellipticBVP<dim>::updateAfterIncrement(){
   //default method does nothing
 }
 
+//methods called when the triangulation is changed, to migrate the cell data of the model
+template <int dim>
+void ellipticBVP<dim>::packCellData(const std::vector<std::pair<unsigned int,unsigned int> >& sources, std::vector<double>& data){
+  //default method has no cell data
+}
+
+template <int dim>
+void ellipticBVP<dim>::resizeCellData(unsigned int numLocalCells){
+  //default method has no cell data
+}
+
+template <int dim>
+void ellipticBVP<dim>::unpackCellData(unsigned int cellID, const std::vector<unsigned int>& quadPtMap, const std::vector<double>& data){
+  //default method has no cell data
+}
+
+//grain ID of a voxel of the voxel aligned mesh
+template <int dim>
+unsigned int ellipticBVP<dim>::getVoxelGrainID(unsigned int voxelIndex[]){
+  //default method has a single grain
+  return 0;
+}
+
+//cell indicator for the plasticity driven adaptive refinement
+template <int dim>
+double ellipticBVP<dim>::getCellRefinementIndicator(unsigned int cellID){
+  //default method gives a uniform indicator
+  return 0.0;
+}
+
+//method called when an increment is reset, to restore the history to the last converged increment
+template <int dim>
+void ellipticBVP<dim>::resetIncrementHistory(){
+  //default method does nothing
+}
+
 #include "../../include/ellipticBVP_template_instantiations.h"
@@ -32,6 +32,12 @@ void ellipticBVP<dim>::init(){
   //If the BCs is not Periodic, locally_relevant_dofs_Mod will remian similar to locally_relevant_dofs.
   locally_relevant_dofs_Mod=locally_relevant_dofs;
 
+  if (userInputs.enableCostWeightedRepartition){
+    cellCost.assign(triangulation.n_locally_owned_active_cells(),0.0);
+  }
+
+  checkUniformCartesianMesh();
+
   pcout << "number of elements: "
   << triangulation.n_global_active_cells()
   << std::endl
@@ -134,15 +140,12 @@ void ellipticBVP<dim>::init(){
     //In the case of Periodic BCs, locally_relevant_dofs_Mod will be updated to
     //include the required DOFs, including global_vector_dof_Boundary_Layer2=(all dofs for elements with a boundary face),
     // edges, and vertices to implement the periodicity over different processors.
-    unsigned int mpi_related_dof,globalDOF1;
+    //global_vector_dof_Boundary_Layer2 is only filled on the processors which have a vertex dof in locally_relevant_dofs_Mod.
+    unsigned int mpi_related_dof;
     for(unsigned int i=0;i<global_size_dof_Boundary_Layer2;i++){
       mpi_related_dof=global_vector_dof_Boundary_Layer2[i];
-      for(unsigned int j=0;j<totalNumVerticesDOFs;j++){
-        globalDOF1=vertices_DOFs_vector[j];
-        if ((locally_relevant_dofs_Mod.is_element(globalDOF1))&&(!locally_relevant_dofs_Mod.is_element(mpi_related_dof))){
-          locally_relevant_dofs_Mod.add_index(mpi_related_dof);
-          break;
-        }
+      if (!locally_relevant_dofs_Mod.is_element(mpi_related_dof)){
+        locally_relevant_dofs_Mod.add_index(mpi_related_dof);
       }
     }
 
@@ -166,29 +169,26 @@ void ellipticBVP<dim>::init(){
       }
     }
 
-    setPeriodicityConstraintsInc0();
-    if(userInputs.enableTabularPeriodicBCs){
-      setPeriodicityConstraintsInc0Neg();
-    }
-    setPeriodicityConstraintsIncNot0();
+    initPeriodicityConstraints();
   }
 
   //initialize global data structures
   solution.reinit (locally_owned_dofs, mpi_communicator); solution=0;
   oldSolution.reinit (locally_owned_dofs, mpi_communicator); oldSolution=0;
+  previousIncrementSolution.reinit (locally_owned_dofs, mpi_communicator); previousIncrementSolution=0;
   solutionWithGhosts.reinit (locally_owned_dofs, locally_relevant_dofs_Mod, mpi_communicator);solutionWithGhosts=0;
   solutionIncWithGhosts.reinit (locally_owned_dofs, locally_relevant_dofs_Mod, mpi_communicator);solutionIncWithGhosts=0;
   residual.reinit (locally_owned_dofs, mpi_communicator); residual=0;
 
-  if(!userInputs.enablePeriodicBCs){
-    DynamicSparsityPattern dsp (locally_relevant_dofs);
-    DoFTools::make_sparsity_pattern (dofHandler, dsp, constraints, false);
-    SparsityTools::distribute_sparsity_pattern (dsp,
-      dofHandler.n_locally_owned_dofs_per_processor(),
-      mpi_communicator,
-      locally_relevant_dofs);
-      jacobian.reinit (locally_owned_dofs, locally_owned_dofs, dsp, mpi_communicator);
-    }
+  //the sparsity pattern only depends on the constraint structure, which does not change
+  //between increments (locally_relevant_dofs_Mod=locally_relevant_dofs for non-periodic BCs)
+  DynamicSparsityPattern dsp (locally_relevant_dofs_Mod);
+  DoFTools::make_sparsity_pattern (dofHandler, dsp, constraints, false);
+  SparsityTools::distribute_sparsity_pattern (dsp,
+    dofHandler.n_locally_owned_dofs_per_processor(),
+    mpi_communicator,
+    locally_relevant_dofs_Mod);
+    jacobian.reinit (locally_owned_dofs, locally_owned_dofs, dsp, mpi_communicator);
 
     // Read boundary conditions
     if((userInputs.enableSimpleBCs)||(userInputs.enableCyclicLoading)){
@@ -358,13 +358,19 @@ void ellipticBVP<dim>::init(){
 
       bcDataFile.close();
 
+      initDICBCs();
+
     }
 
+    //list the constrained boundary DOFs once
+    initDirichletBCs();
+
     Fprev=IdentityMatrix(dim);
 
     //apply initial conditions
     applyInitialConditions();
     solutionWithGhosts=solution;
     oldSolution=solution;
+    previousIncrementSolution=solution;
   }
   #include "../../include/ellipticBVP_template_instantiations.h"
@@ -24,7 +24,7 @@ bool ellipticBVP<dim>::testConvergenceAfterIteration(){
     resetIncrement=false;
     char buffer[100];
     sprintf(buffer,
-	    "current increment reset by model. Restarting increment with loadFactorSetByModel: %12.6e\n",
+	    "current increment reset. Restarting increment with loadFactorSetByModel: %12.6e\n",
 	    loadFactorSetByModel);
     pcout << buffer;
     return false;
@@ -0,0 +1,59 @@
+//memory consumption report for ellipticBVP class
+#include "../../include/ellipticBVP.h"
+
+//prints the bytes used by the main data structures as the minimum and maximum over the processors
+//and the total over all processors, followed by their sum and the resident set size of the processes
+template <int dim>
+void ellipticBVP<dim>::reportMemoryConsumption(){
+  std::vector<std::pair<std::string,std::size_t> > entries;
+  entries.push_back(std::make_pair("triangulation", triangulation.memory_consumption()));
+  entries.push_back(std::make_pair("DoF handlers", dofHandler.memory_consumption()+dofHandler_Scalar.memory_consumption()));
+  entries.push_back(std::make_pair("constraints", constraints.memory_consumption()+constraintsMassMatrix.memory_consumption()));
+  entries.push_back(std::make_pair("jacobian", jacobian.memory_consumption()));
+  entries.push_back(std::make_pair("massMatrix", massMatrix.memory_consumption()));
+
+  std::size_t bytes=solution.memory_consumption()+oldSolution.memory_consumption()+residual.memory_consumption()
+    +previousIncrementSolution.memory_consumption()+solutionWithGhosts.memory_consumption()+solutionIncWithGhosts.memory_consumption();
+  entries.push_back(std::make_pair("solution vectors", bytes));
+
+  bytes=0;
+  for (unsigned int field=0; field<postFields.size(); field++){
+    bytes+=postFields[field]->memory_consumption()+postFieldsWithGhosts[field]->memory_consumption()+postResidual[field]->memory_consumption();
+  }
+  entries.push_back(std::make_pair("post-processing vectors", bytes));
+  entries.push_back(std::make_pair("postprocessValues", postprocessValues.memory_consumption()+postprocessValuesAtCellCenters.memory_consumption()));
+
+  //map nodes hold the value and the links of the tree
+  entries.push_back(std::make_pair("support points", supportPoints.size()*(sizeof(std::pair<const types::global_dof_index, Point<dim> >)+4*sizeof(void*))));
+  entries.push_back(std::make_pair("cell costs", MemoryConsumption::memory_consumption(cellCost)));
+
+  addMemoryConsumption(entries);
+
+  char buffer[200];
+  sprintf(buffer, "\n%-34s %12s %12s %12s\n", "memory consumption (MB)", "min/proc", "max/proc", "total");
+  pcout << buffer;
+  std::size_t localTotal=0;
+  for (unsigned int i=0; i<entries.size(); i++){
+    localTotal+=entries[i].second;
+    const Utilities::MPI::MinMaxAvg stats=Utilities::MPI::min_max_avg(entries[i].second/1048576.0, mpi_communicator);
+    //data structures which are not allocated on any processor are not listed
+    if (stats.max==0.0) continue;
+    sprintf(buffer, "  %-32s %12.2f %12.2f %12.2f\n", entries[i].first.c_str(), stats.min, stats.max, stats.sum);
+    pcout << buffer;
+  }
+  Utilities::MPI::MinMaxAvg stats=Utilities::MPI::min_max_avg(localTotal/1048576.0, mpi_communicator);
+  sprintf(buffer, "  %-32s %12.2f %12.2f %12.2f\n", "sum of the above", stats.min, stats.max, stats.sum);
+  pcout << buffer;
+
+  Utilities::System::MemoryStats memoryStats;
+  Utilities::System::get_memory_stats(memoryStats);
+  stats=Utilities::MPI::min_max_avg(memoryStats.VmRSS/1024.0, mpi_communicator);
+  sprintf(buffer, "  %-32s %12.2f %12.2f %12.2f\n\n", "resident set size", stats.min, stats.max, stats.sum);
+  pcout << buffer;
+}
+
+template <int dim>
+void ellipticBVP<dim>::addMemoryConsumption(std::vector<std::pair<std::string,std::size_t> >& entries){
+  //default method has no model data structures
+}
+#include "../../include/ellipticBVP_template_instantiations.h"
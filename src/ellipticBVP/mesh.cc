@@ -31,6 +31,20 @@ void ellipticBVP<dim>::mesh(){
 
     GridGenerator::subdivided_hyper_rectangle (triangulation, userInputs.subdivisions, Point<dim>(), Point<dim>(userInputs.span[0],userInputs.span[1],userInputs.span[2]), true);
 
+    //voxel aligned mesh: the grain ID of each cell is found by integer indexing of the voxels it covers
+    //and stored as material_id
+    if(userInputs.voxelAlignedMesh){
+      //octree refinement of the coarse cells which cover more than one grain, down to the voxels
+      for (unsigned int level=0; level<userInputs.grainInteriorCoarseningLevels; level++){
+        if (!setVoxelMaterialIDs(true)) break;
+        triangulation.execute_coarsening_and_refinement();
+      }
+      if (userInputs.grainInteriorCoarseningLevels>0){
+        pcout << "grain interior coarsened mesh: " << triangulation.n_global_active_cells() << " cells for "
+        << userInputs.numPts[0]*userInputs.numPts[1]*userInputs.numPts[2] << " voxels\n";
+      }
+    }
+
   //In the case of Periodic BCs, it connects the periodic faces to each other,
   //and add those dofs as ghost cells of the other face.
     if(userInputs.enablePeriodicBCs){
@@ -40,6 +54,12 @@ void ellipticBVP<dim>::mesh(){
 
     triangulation.refine_global (userInputs.meshRefineFactor);
 
+    //refined cells moved to another processor by the repartitioning inherit the material_id of
+    //their coarse cell, so the grain IDs are assigned again on the final mesh
+    if(userInputs.voxelAlignedMesh){
+      setVoxelMaterialIDs(false);
+    }
+
     //Output image of the mesh in eps format
     if(userInputs.writeMeshToEPS)
       if ((triangulation.n_global_active_cells()<10000) and (Utilities::MPI::n_mpi_processes(mpi_communicator)==1)){
@@ -54,4 +74,49 @@ void ellipticBVP<dim>::mesh(){
       }
   }
 }
+//Set the material_id of every active cell of the voxel aligned mesh to the grain ID of the voxels it
+//covers, by integer indexing of the voxel grid. A cell of level l covers 2^(grainInteriorCoarseningLevels-l)
+//voxels in each direction. If flagMixedCells, locally owned cells covering more than one grain are flagged
+//for refinement, returns true if any cell was flagged.
+template <int dim>
+bool ellipticBVP<dim>::setVoxelMaterialIDs(bool flagMixedCells){
+  std::vector<double> voxelSize(dim);
+  for (unsigned int i=0; i<dim; ++i){
+    voxelSize[i]=userInputs.span[i]/userInputs.numPts[i];
+  }
+
+  unsigned int numFlaggedCells=0;
+  unsigned int voxelIndex[3]={0,0,0}, firstVoxel[3]={0,0,0}, numVoxels[3]={1,1,1};
+  typename Triangulation<dim>::active_cell_iterator cell = triangulation.begin_active(), endc = triangulation.end();
+  for (; cell!=endc; ++cell) {
+    if (cell->is_artificial()) continue;
+    const unsigned int levels=userInputs.grainInteriorCoarseningLevels;
+    const unsigned int n=((unsigned int)cell->level()<levels) ? (1<<(levels-cell->level())) : 1;
+    const Point<dim> center=cell->center();
+    for (unsigned int i=0; i<dim; ++i){
+      firstVoxel[i]=(unsigned int)std::max(0.0, std::floor(center[i]/voxelSize[i]-0.5*n+0.5));
+      firstVoxel[i]=std::min(firstVoxel[i], userInputs.numPts[i]-n);
+      numVoxels[i]=n;
+    }
+
+    const unsigned int grainID=getVoxelGrainID(firstVoxel);
+    bool singleGrain=true;
+    for (unsigned int x=0; (x<numVoxels[0])&&singleGrain; x++){
+      for (unsigned int y=0; (y<numVoxels[1])&&singleGrain; y++){
+        for (unsigned int z=0; (z<numVoxels[2])&&singleGrain; z++){
+          voxelIndex[0]=firstVoxel[0]+x; voxelIndex[1]=firstVoxel[1]+y; voxelIndex[2]=firstVoxel[2]+z;
+          if (getVoxelGrainID(voxelIndex)!=grainID) singleGrain=false;
+        }
+      }
+    }
+
+    cell->set_material_id(grainID);
+    if (flagMixedCells&&(!singleGrain)&&(cell->is_locally_owned())){
+      cell->set_refine_flag();
+      numFlaggedCells++;
+    }
+  }
+
+  return (Utilities::MPI::sum(numFlaggedCells, mpi_communicator)>0);
+}
 #include "../../include/ellipticBVP_template_instantiations.h"
@@ -2,6 +2,7 @@
 #include "../../include/ellipticBVP.h"
 #include <fstream>
 #include <iostream>
+#include <set>
 
 //loop over increments and solve each increment
 template <int dim>
@@ -37,43 +38,33 @@ void ellipticBVP<dim>::setPeriodicityConstraintsInit(){
 
 //////////////////////////Initialization Start////////////////////////////////
 //vertices_DOFs: This index set has the global dofs for vertices.
-  vertices_DOFs.set_size(1000000000);
-  dof_Boundary_Layer2.set_size(1000000000);
-  Edges_DOFs_1.set_size(1000000000);
-  Edges_DOFs_2.set_size(1000000000);
-  Edges_DOFs_3.set_size(1000000000);
+  vertices_DOFs.set_size(dofHandler.n_dofs());
+  dof_Boundary_Layer2.set_size(dofHandler.n_dofs());
 
   totalNumEdgesDOFs=36;
   periodicBCsInput=userInputs.periodicBCsInput;
   periodicBCsInput2_Orig=userInputs.periodicBCsInput2;
   totalNumVerticesDOFs=24;
-  totalNumEachEdgesNodes=userInputs.subdivisions[1]-1;
+  //Number of interior nodes on each edge of the (uniformly discretized) cube
+  totalNumEachEdgesNodes=(userInputs.subdivisions[1]<<userInputs.meshRefineFactor)-1;
+  //the edge nodes are assigned to their slots from their coordinate along the edge, which requires the same
+  //number of equally spaced linear elements along all edges (checked again for every edge node below)
+  AssertThrow((userInputs.subdivisions[0]==userInputs.subdivisions[1])&&(userInputs.subdivisions[2]==userInputs.subdivisions[1]),
+    ExcMessage("periodic boundary conditions require the same number of subdivisions in all directions"));
+  AssertThrow(userInputs.feOrder==1, ExcMessage("periodic boundary conditions require linear elements (Order of finite elements = 1)"));
   totalNumFacesDOFs=18;
 
   IndexSet dof_FXN_1,dof_FXN_2,dof_FXN_3, dof_FXP_1, dof_FXP_2, dof_FXP_3;
   IndexSet dof_FYN_1,dof_FYN_2,dof_FYN_3, dof_FYP_1, dof_FYP_2, dof_FYP_3;
   IndexSet dof_FZN_1,dof_FZN_2,dof_FZN_3, dof_FZP_1, dof_FZP_2, dof_FZP_3;
 
-  unsigned int flagVertices;
   unsigned int check1,check2;
   unsigned int kFlag=0;
-  unsigned int local_num_Edges_nodes;
-  unsigned int size_dof_Edge_processor;
-  unsigned int checkBoundary_id;
-  unsigned int n_processes;
-  unsigned int size_dof_Boundary_Layer2;
-  unsigned int total_num_edges_node_processor;
-
-  double node0,node1,node2;
-
-  std::vector<std::vector<unsigned int> >  global_Edges_DOFs_Vector,Edges_DOFs_Vector,local_Edges_DOFs_Vector;
-  std::vector<std::vector<double>>  global_Edges_DOFs_Coord_Vector,Edges_DOFs_Coord_Vector,local_Edges_DOFs_Coord_Vector;
-
 
   const unsigned int   dofs_per_cell   = FE.dofs_per_cell;
+  const unsigned int   dofs_per_face   = FE.dofs_per_face;
   std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
-  FEValues<dim> fe_values (FE, QGauss<dim>(userInputs.quadOrder), update_values);
-  FEFaceValues<dim> fe_face_values (FE, QGauss<dim-1>(userInputs.quadOrder), update_values);
+  std::vector<types::global_dof_index> face_dof_indices (dofs_per_face);
 
 //vertices_DOFs_vector: This vector has the the global dofs for vertices.
   vertices_DOFs_vector.resize(totalNumVerticesDOFs,0);
@@ -88,22 +79,6 @@ void ellipticBVP<dim>::setPeriodicityConstraintsInit(){
 //faces_dof_Index_vector:In each row of this vector, an indexset of dof for each face is saved.
   faces_dof_Index_vector.resize(totalNumFacesDOFs);
 
-  globalDOF_V000_1=0;globalDOF_V000_2=0;globalDOF_V000_3=0;globalDOF_V001_1=0;
-  globalDOF_V001_2=0;globalDOF_V001_3=0;globalDOF_V010_1=0;globalDOF_V010_2=0;
-  globalDOF_V010_3=0;globalDOF_V100_1=0;globalDOF_V100_2=0;globalDOF_V100_3=0;
-
-  globalDOF_V011_1=0;globalDOF_V011_2=0;globalDOF_V011_3=0;globalDOF_V110_1=0;
-  globalDOF_V110_2=0;globalDOF_V110_3=0;globalDOF_V101_1=0;globalDOF_V101_2=0;
-  globalDOF_V101_3=0;globalDOF_V111_1=0;globalDOF_V111_2=0;globalDOF_V111_3=0;
-
-  local_globalDOF_V000_1=0;local_globalDOF_V000_2=0;local_globalDOF_V000_3=0;local_globalDOF_V001_1=0;
-  local_globalDOF_V001_2=0;local_globalDOF_V001_3=0;local_globalDOF_V010_1=0;local_globalDOF_V010_2=0;
-  local_globalDOF_V010_3=0;local_globalDOF_V100_1=0;local_globalDOF_V100_2=0;local_globalDOF_V100_3=0;
-
-  local_globalDOF_V011_1=0;local_globalDOF_V011_2=0;local_globalDOF_V011_3=0;local_globalDOF_V110_1=0;
-  local_globalDOF_V110_2=0;local_globalDOF_V110_3=0;local_globalDOF_V101_1=0;local_globalDOF_V101_2=0;
-  local_globalDOF_V101_3=0;local_globalDOF_V111_1=0;local_globalDOF_V111_2=0;local_globalDOF_V111_3=0;
-
   if(userInputs.enableTabularPeriodicBCs){
     for(unsigned int i=0;i<totalNumVerticesDOFs;i++){
       periodicBCsInput2_Orig[0][i]=periodicBCsInput2_Orig[0][i]/periodicTotalIncrements;
@@ -185,36 +160,6 @@ void ellipticBVP<dim>::setPeriodicityConstraintsInit(){
   DoFTools::extract_boundary_dofs(dofHandler, FE.component_mask(displacementZ),dof_FZP_3,boundary_ids3);
   DoFTools::extract_boundary_dofs(dofHandler, ComponentMask(),dof_FZP,boundary_ids3);
 
-//Here, We merge dof_FXP,dof_FYP, and dof_FZP as dof_FP to include all dofs of positive faces.
-  dof_FP=dof_FXP;
-  if (dof_FYP.n_elements()>0){
-    IndexSet::ElementIterator dof_FYP_counter = dof_FYP.begin();
-    if (!dof_FP.is_element(*dof_FYP_counter)){
-      dof_FP.add_index(*dof_FYP_counter);
-    }
-    for(unsigned int j = 1; j < dof_FYP.n_elements(); j++){
-      dof_FYP_counter++;
-      if (!dof_FP.is_element(*dof_FYP_counter)){
-        dof_FP.add_index(*dof_FYP_counter);
-      }
-    }
-  }
-
-
-  if (dof_FZP.n_elements()>0){
-    IndexSet::ElementIterator dof_FZP_counter = dof_FZP.begin();
-    if (!dof_FP.is_element(*dof_FZP_counter)){
-      dof_FP.add_index(*dof_FZP_counter);
-    }
-    for(unsigned int j = 1; j < dof_FZP.n_elements(); j++){
-      dof_FZP_counter++;
-      if (!dof_FP.is_element(*dof_FZP_counter)){
-        dof_FP.add_index(*dof_FZP_counter);
-      }
-    }
-  }
-
-
 //Here, we are doing the same for negative faces.
   std::set< types::boundary_id > boundary_ids4;
   boundary_ids4.insert(0);
@@ -225,7 +170,6 @@ void ellipticBVP<dim>::setPeriodicityConstraintsInit(){
 
   std::set< types::boundary_id > boundary_ids5;
   boundary_ids5.insert(2);
-  // const FEValuesExtractors::Scalar  displacementY(1);
   DoFTools::extract_boundary_dofs(dofHandler, FE.component_mask(displacementX),dof_FYN_1,boundary_ids5);
   DoFTools::extract_boundary_dofs(dofHandler, FE.component_mask(displacementY),dof_FYN_2,boundary_ids5);
   DoFTools::extract_boundary_dofs(dofHandler, FE.component_mask(displacementZ),dof_FYN_3,boundary_ids5);
@@ -233,7 +177,6 @@ void ellipticBVP<dim>::setPeriodicityConstraintsInit(){
 
   std::set< types::boundary_id > boundary_ids6;
   boundary_ids6.insert(4);
-  // const FEValuesExtractors::Scalar  displacementZ(2);
   DoFTools::extract_boundary_dofs(dofHandler, FE.component_mask(displacementX),dof_FZN_1,boundary_ids6);
   DoFTools::extract_boundary_dofs(dofHandler, FE.component_mask(displacementY),dof_FZN_2,boundary_ids6);
   DoFTools::extract_boundary_dofs(dofHandler, FE.component_mask(displacementZ),dof_FZN_3,boundary_ids6);
@@ -241,31 +184,8 @@ void ellipticBVP<dim>::setPeriodicityConstraintsInit(){
 
 //Here, We merge dof_FXN,dof_FYN, and dof_FZN as dof_FN to include all dofs of negative faces.
   dof_FN=dof_FXN;
-  if (dof_FYN.n_elements()>0){
-    IndexSet::ElementIterator dof_FYN_counter = dof_FYN.begin();
-    if (!dof_FN.is_element(*dof_FYN_counter)){
-      dof_FN.add_index(*dof_FYN_counter);
-    }
-    for(unsigned int j = 1; j < dof_FYN.n_elements(); j++){
-      dof_FYN_counter++;
-      if (!dof_FN.is_element(*dof_FYN_counter)){
-        dof_FN.add_index(*dof_FYN_counter);
-      }
-    }
-  }
-
-  if (dof_FZN.n_elements()>0){
-    IndexSet::ElementIterator dof_FZN_counter = dof_FZN.begin();
-    if (!dof_FN.is_element(*dof_FZN_counter)){
-      dof_FN.add_index(*dof_FZN_counter);
-    }
-    for(unsigned int j = 1; j < dof_FZN.n_elements(); j++){
-      dof_FZN_counter++;
-      if (!dof_FN.is_element(*dof_FZN_counter)){
-        dof_FN.add_index(*dof_FZN_counter);
-      }
-    }
-  }
+  dof_FN.add_indices(dof_FYN);
+  dof_FN.add_indices(dof_FZN);
 
 
 /////Assigning the dof for each face into a vector faces_dof_Index_vector.
@@ -278,210 +198,105 @@ void ellipticBVP<dim>::setPeriodicityConstraintsInit(){
   faces_dof_Index_vector[12]=dof_FZN_1; faces_dof_Index_vector[13]=dof_FZN_2; faces_dof_Index_vector[14]=dof_FZN_3;
   faces_dof_Index_vector[15]=dof_FZP_1; faces_dof_Index_vector[16]=dof_FZP_2; faces_dof_Index_vector[17]=dof_FZP_3;
 
+//The periodic face pairs only depend on the mesh, so they are collected once here
+//and reused by setFaceConstraints() for all constraint matrices.
+  periodicity_vectorX.clear(); periodicity_vectorY.clear(); periodicity_vectorZ.clear();
+///Here, we assumed that in the face constraints lines, we always start with FXP, FYP, or FZP.
+  GridTools::collect_periodic_faces(dofHandler, /*b_id1*/ 1, /*b_id2*/ 0, /*direction*/ 0, periodicity_vectorX);
+  GridTools::collect_periodic_faces(dofHandler, /*b_id1*/ 3, /*b_id2*/ 2, /*direction*/ 1, periodicity_vectorY);
+  GridTools::collect_periodic_faces(dofHandler, /*b_id1*/ 5, /*b_id2*/ 4, /*direction*/ 2, periodicity_vectorZ);
+
 ///////////////////////Defining different dofs on the faces End//////////////
 
-///////////////////////Defining global dofs for Vertices Start//////////////
-//(DOFs on Edeges are also defined here which will be used later)
-  //Here, for each processor, it goes over all the locally_owned cells and try to find the global dofs for Vertices
-  //and Edges. Since it iis for each processor, we call it local_globalDOF.
-  //Later one, we merged all the numbers for all processors and get the global and transfer it to all processors to have it.
+///////////////////////Defining global dofs for Vertices and Edges Start//////////////
+  //Here, each processor goes over the boundary faces of its locally_owned cells and finds the global dofs of
+  //the vertices and of the (interior) edge nodes. Every vertex dof and every edge node has a fixed slot in
+  //local_Vertices_Edges_DOFs: the vertices are ordered as V000,V100,V010,V001,V110,V101,V011,V111 (3 dofs each),
+  //followed by the dof-0 of the edge nodes of EX000,EX001,EX010,EX011,EY000,EY001,EY100,EY101,EZ000,EZ010,EZ100,EZ110,
+  //each edge ordered by the coordinate along the edge (the edge nodes must be uniformly spaced).
+  //The slots hold the global dof plus one, and processors which do not see a vertex or an edge node keep 0
+  //in its slot, so a single max reduction gives the global dofs on all processors and shows empty slots.
+  //The last 8 slots hold the owner (plus one) of the dofs of each vertex, i.e. the processor owning the
+  //cell at that corner of the domain, which collects the boundary layer dofs below.
   //It is important to know that it is assumed here that the sample is a cuboid with x->[0,userInputs.span[0]]
   //y->[0,userInputs.span[1]], and z->[0,userInputs.span[2]].
+  const unsigned int vertexOrder[8]={0,1,2,4,3,5,6,7};
+  const unsigned int cornerOwnersOffset=totalNumVerticesDOFs+12*totalNumEachEdgesNodes;
+  const unsigned int this_process=Utilities::MPI::this_mpi_process(mpi_communicator);
+  std::vector<unsigned int> local_Vertices_Edges_DOFs(cornerOwnersOffset+8,0);
+
   typename DoFHandler<dim>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
   for (; cell!=endc; ++cell) {
     if (cell->is_locally_owned()){
-      cell->get_dof_indices (local_dof_indices);
-      fe_values.reinit (cell);
       for (unsigned int faceID=0; faceID<2*dim; faceID++){
         if (cell->face(faceID)->at_boundary()){
-          fe_face_values.reinit (cell, faceID);
-          for (unsigned int i=0; i<dofs_per_cell; ++i) {
-            if (fe_face_values.shape_value(i, 0)!=0){
-              const unsigned int dof = fe_values.get_fe().system_to_component_index(i).first;
-              unsigned int globalDOF=local_dof_indices[i];
-              bool flag=false;
-              double value=0;
-              node=supportPoints[globalDOF];
-              flagVertices=0;
-
-              if ((node[0] <= externalMeshParameterBCs(0))&&(node[1] <= externalMeshParameterBCs(1))&&(node[2] <= externalMeshParameterBCs(2))){
-                flagVertices=1;
-                if (dof==0){
-                  local_globalDOF_V000_1=globalDOF;
-                }
-                if (dof==1){
-                  local_globalDOF_V000_2=globalDOF;
-                }
-                if (dof==2){
-                  local_globalDOF_V000_3=globalDOF;
-                }
-              }
-
-              if ((node[0] >= (userInputs.span[0]-externalMeshParameterBCs(0)))&&(node[1] <= externalMeshParameterBCs(1))&&(node[2] <= externalMeshParameterBCs(2))){
-                flagVertices=1;
-                if (dof==0){
-                  local_globalDOF_V100_1=globalDOF;
-                }
-                if (dof==1){
-                  local_globalDOF_V100_2=globalDOF;
-                }
-                if (dof==2){
-                  local_globalDOF_V100_3=globalDOF;
-                }
-              }
-
-              if ((node[1] >= (userInputs.span[1]-externalMeshParameterBCs(1)))&&(node[0] <= externalMeshParameterBCs(0))&&(node[2] <= externalMeshParameterBCs(2))){
-                flagVertices=1;
-                if (dof==0){
-                  local_globalDOF_V010_1=globalDOF;
-                }
-                if (dof==1){
-                  local_globalDOF_V010_2=globalDOF;
-                }
-                if (dof==2){
-                  local_globalDOF_V010_3=globalDOF;
-                }
-              }
-
-              if ((node[2] >= (userInputs.span[2]-externalMeshParameterBCs(2)))&&(node[0] <= externalMeshParameterBCs(0))&&(node[1] <= externalMeshParameterBCs(1))){
-                flagVertices=1;
-                if (dof==0){
-                  local_globalDOF_V001_1=globalDOF;
-                }
-                if (dof==1){
-                  local_globalDOF_V001_2=globalDOF;
-                }
-                if (dof==2){
-                  local_globalDOF_V001_3=globalDOF;
-                }
-              }
-
-              if ((node[0] >= (userInputs.span[0]-externalMeshParameterBCs(0)))&&(node[1] >= (userInputs.span[1]-externalMeshParameterBCs(1)))&&(node[2] <= externalMeshParameterBCs(2))){
-                flagVertices=1;
-                if (dof==0){
-                  local_globalDOF_V110_1=globalDOF;
-                }
-                if (dof==1){
-                  local_globalDOF_V110_2=globalDOF;
-                }
-                if (dof==2){
-                  local_globalDOF_V110_3=globalDOF;
-                }
-              }
-
-              if ((node[0] >= (userInputs.span[0]-externalMeshParameterBCs(0)))&&(node[2] >= (userInputs.span[2]-externalMeshParameterBCs(2)))&&(node[1] <= externalMeshParameterBCs(1))){
-                flagVertices=1;
-                if (dof==0){
-                  local_globalDOF_V101_1=globalDOF;
-                }
-                if (dof==1){
-                  local_globalDOF_V101_2=globalDOF;
-                }
-                if (dof==2){
-                  local_globalDOF_V101_3=globalDOF;
-                }
-              }
-
-              if ((node[1] >= (userInputs.span[1]-externalMeshParameterBCs(1)))&&(node[2] >= (userInputs.span[2]-externalMeshParameterBCs(2)))&&(node[0] <= externalMeshParameterBCs(0))){
-                flagVertices=1;
-                if (dof==0){
-                  local_globalDOF_V011_1=globalDOF;
-                }
-                if (dof==1){
-                  local_globalDOF_V011_2=globalDOF;
-                }
-                if (dof==2){
-                  local_globalDOF_V011_3=globalDOF;
-                }
-              }
+          cell->face(faceID)->get_dof_indices (face_dof_indices);
+          for (unsigned int i=0; i<dofs_per_face; ++i) {
+            const unsigned int dof = FE.face_system_to_component_index(i).first;
+            unsigned int globalDOF=face_dof_indices[i];
+            node=supportPoints[globalDOF];
+
+            unsigned int numBoundaryDirections=0, vertexBits=0;
+            bool onBoundary[3], onPositiveFace[3];
+            for (unsigned int d=0; d<3; d++){
+              onPositiveFace[d]=(node[d] >= (userInputs.span[d]-externalMeshParameterBCs(d)));
+              onBoundary[d]=(onPositiveFace[d])||(node[d] <= externalMeshParameterBCs(d));
+              if (onBoundary[d]) numBoundaryDirections++;
+              if (onPositiveFace[d]) vertexBits+=(1<<d);
+            }
 
-              if ((node[0] >= (userInputs.span[0]-externalMeshParameterBCs(0)))&&(node[1] >= (userInputs.span[1]-externalMeshParameterBCs(1)))&&(node[2] >= (userInputs.span[2]-externalMeshParameterBCs(2)))){
-                flagVertices=1;
-                if (dof==0){
-                  local_globalDOF_V111_1=globalDOF;
-                }
-                if (dof==1){
-                  local_globalDOF_V111_2=globalDOF;
-                }
-                if (dof==2){
-                  local_globalDOF_V111_3=globalDOF;
-                }
-              }
-              if (flagVertices==0){
-                if ((((node[0] >= (userInputs.span[0]-externalMeshParameterBCs(0)))||(node[0] <= externalMeshParameterBCs(0)))&&
-                ((node[1] >= (userInputs.span[1]-externalMeshParameterBCs(1)))||(node[1] <= externalMeshParameterBCs(1))))||
-                (((node[0] >= (userInputs.span[0]-externalMeshParameterBCs(0)))||(node[0] <= externalMeshParameterBCs(0)))&&
-                ((node[2] >= (userInputs.span[2]-externalMeshParameterBCs(2)))||(node[2] <= externalMeshParameterBCs(2))))||
-                (((node[2] >= (userInputs.span[2]-externalMeshParameterBCs(2)))||(node[2] <= externalMeshParameterBCs(2)))&&
-                ((node[1] >= (userInputs.span[1]-externalMeshParameterBCs(1)))||(node[1] <= externalMeshParameterBCs(1))))){
-                  if (dof==0){
-                    Edges_DOFs_1.add_index(globalDOF);
-                  }
-                  if (dof==1){
-                    Edges_DOFs_2.add_index(globalDOF);
-                  }
-                  if (dof==2){
-                    Edges_DOFs_3.add_index(globalDOF);
-                  }
-                }
+            if (numBoundaryDirections==3){
+              local_Vertices_Edges_DOFs[3*vertexOrder[vertexBits]+dof]=globalDOF+1;
+              if ((dof==0)&&(locally_owned_dofs.is_element(globalDOF))){
+                local_Vertices_Edges_DOFs[cornerOwnersOffset+vertexOrder[vertexBits]]=this_process+1;
               }
             }
+            else if ((numBoundaryDirections==2)&&(dof==0)&&(totalNumEachEdgesNodes>0)){
+              unsigned int a=0;
+              while (onBoundary[a]) a++;
+              const unsigned int b=(a==0)?1:0;
+              const unsigned int c=(a==2)?1:2;
+              const unsigned int edgeID=4*a+2*onPositiveFace[b]+onPositiveFace[c];
+              const double nodeSpacing=userInputs.span[a]/(totalNumEachEdgesNodes+1);
+              const int k=int(node[a]/nodeSpacing+0.5)-1;
+              AssertThrow((k>=0)&&(k<int(totalNumEachEdgesNodes))&&(std::fabs(node[a]-(k+1)*nodeSpacing)<1.0e-6*nodeSpacing),
+                ExcMessage("periodic boundary conditions require uniformly spaced nodes along the edges of the domain"));
+              local_Vertices_Edges_DOFs[totalNumVerticesDOFs+edgeID*totalNumEachEdgesNodes+k]=globalDOF+1;
+            }
           }
         }
       }
     }
   }
 
-  //Here, it goes over all processors. The processors which does not include
-  //any of the globalDOF, they initialized zero. accordingly, the max among all processors
-  //will give the real global_DOF.
-  globalDOF_V000_1=Utilities::MPI::max(local_globalDOF_V000_1,mpi_communicator);
-  globalDOF_V000_2=Utilities::MPI::max(local_globalDOF_V000_2,mpi_communicator);
-  globalDOF_V000_3=Utilities::MPI::max(local_globalDOF_V000_3,mpi_communicator);
-  globalDOF_V001_1=Utilities::MPI::max(local_globalDOF_V001_1,mpi_communicator);
-  globalDOF_V001_2=Utilities::MPI::max(local_globalDOF_V001_2,mpi_communicator);
-  globalDOF_V001_3=Utilities::MPI::max(local_globalDOF_V001_3,mpi_communicator);
-  globalDOF_V010_1=Utilities::MPI::max(local_globalDOF_V010_1,mpi_communicator);
-  globalDOF_V010_2=Utilities::MPI::max(local_globalDOF_V010_2,mpi_communicator);
-  globalDOF_V010_3=Utilities::MPI::max(local_globalDOF_V010_3,mpi_communicator);
-  globalDOF_V100_1=Utilities::MPI::max(local_globalDOF_V100_1,mpi_communicator);
-  globalDOF_V100_2=Utilities::MPI::max(local_globalDOF_V100_2,mpi_communicator);
-  globalDOF_V100_3=Utilities::MPI::max(local_globalDOF_V100_3,mpi_communicator);
-
-  globalDOF_V011_1=Utilities::MPI::max(local_globalDOF_V011_1,mpi_communicator);
-  globalDOF_V011_2=Utilities::MPI::max(local_globalDOF_V011_2,mpi_communicator);
-  globalDOF_V011_3=Utilities::MPI::max(local_globalDOF_V011_3,mpi_communicator);
-  globalDOF_V110_1=Utilities::MPI::max(local_globalDOF_V110_1,mpi_communicator);
-  globalDOF_V110_2=Utilities::MPI::max(local_globalDOF_V110_2,mpi_communicator);
-  globalDOF_V110_3=Utilities::MPI::max(local_globalDOF_V110_3,mpi_communicator);
-  globalDOF_V101_1=Utilities::MPI::max(local_globalDOF_V101_1,mpi_communicator);
-  globalDOF_V101_2=Utilities::MPI::max(local_globalDOF_V101_2,mpi_communicator);
-  globalDOF_V101_3=Utilities::MPI::max(local_globalDOF_V101_3,mpi_communicator);
-  globalDOF_V111_1=Utilities::MPI::max(local_globalDOF_V111_1,mpi_communicator);
-  globalDOF_V111_2=Utilities::MPI::max(local_globalDOF_V111_2,mpi_communicator);
-  globalDOF_V111_3=Utilities::MPI::max(local_globalDOF_V111_3,mpi_communicator);
+  std::vector<unsigned int> global_Vertices_Edges_DOFs(local_Vertices_Edges_DOFs.size(),0);
+  Utilities::MPI::max(local_Vertices_Edges_DOFs,mpi_communicator,global_Vertices_Edges_DOFs);
+  for(unsigned int i=0;i<global_Vertices_Edges_DOFs.size();i++){
+    AssertThrow(global_Vertices_Edges_DOFs[i]>0,
+      ExcMessage("periodic boundary conditions: a vertex or edge node of the domain was not found"));
+    global_Vertices_Edges_DOFs[i]--;
+  }
 
-//vertices_DOFs: This index set has the global dofs for vertices.
-  vertices_DOFs.add_index(globalDOF_V000_1);vertices_DOFs.add_index(globalDOF_V000_2);vertices_DOFs.add_index(globalDOF_V000_3);
-  vertices_DOFs.add_index(globalDOF_V100_1);vertices_DOFs.add_index(globalDOF_V100_2);vertices_DOFs.add_index(globalDOF_V100_3);
-  vertices_DOFs.add_index(globalDOF_V010_1);vertices_DOFs.add_index(globalDOF_V010_2);vertices_DOFs.add_index(globalDOF_V010_3);
-  vertices_DOFs.add_index(globalDOF_V001_1);vertices_DOFs.add_index(globalDOF_V001_2);vertices_DOFs.add_index(globalDOF_V001_3);
-  vertices_DOFs.add_index(globalDOF_V110_1);vertices_DOFs.add_index(globalDOF_V110_2);vertices_DOFs.add_index(globalDOF_V110_3);
-  vertices_DOFs.add_index(globalDOF_V101_1);vertices_DOFs.add_index(globalDOF_V101_2);vertices_DOFs.add_index(globalDOF_V101_3);
-  vertices_DOFs.add_index(globalDOF_V011_1);vertices_DOFs.add_index(globalDOF_V011_2);vertices_DOFs.add_index(globalDOF_V011_3);
-  vertices_DOFs.add_index(globalDOF_V111_1);vertices_DOFs.add_index(globalDOF_V111_2);vertices_DOFs.add_index(globalDOF_V111_3);
+//vertices_DOFs_vector and vertices_DOFs: the global dofs for vertices.
+  for(unsigned int i=0;i<totalNumVerticesDOFs;i++){
+    vertices_DOFs_vector[i]=global_Vertices_Edges_DOFs[i];
+    vertices_DOFs.add_index(vertices_DOFs_vector[i]);
+  }
 
-//vertices_DOFs_vector: This vector has the the global dofs for vertices.
-  vertices_DOFs_vector[0]=globalDOF_V000_1;vertices_DOFs_vector[1]=globalDOF_V000_2;vertices_DOFs_vector[2]=globalDOF_V000_3;
-  vertices_DOFs_vector[3]=globalDOF_V100_1;vertices_DOFs_vector[4]=globalDOF_V100_2;vertices_DOFs_vector[5]=globalDOF_V100_3;
-  vertices_DOFs_vector[6]=globalDOF_V010_1;vertices_DOFs_vector[7]=globalDOF_V010_2;vertices_DOFs_vector[8]=globalDOF_V010_3;
-  vertices_DOFs_vector[9]=globalDOF_V001_1;vertices_DOFs_vector[10]=globalDOF_V001_2;vertices_DOFs_vector[11]=globalDOF_V001_3;
-  vertices_DOFs_vector[12]=globalDOF_V110_1;vertices_DOFs_vector[13]=globalDOF_V110_2;vertices_DOFs_vector[14]=globalDOF_V110_3;
-  vertices_DOFs_vector[15]=globalDOF_V101_1;vertices_DOFs_vector[16]=globalDOF_V101_2;vertices_DOFs_vector[17]=globalDOF_V101_3;
-  vertices_DOFs_vector[18]=globalDOF_V011_1;vertices_DOFs_vector[19]=globalDOF_V011_2;vertices_DOFs_vector[20]=globalDOF_V011_3;
-  vertices_DOFs_vector[21]=globalDOF_V111_1;vertices_DOFs_vector[22]=globalDOF_V111_2;vertices_DOFs_vector[23]=globalDOF_V111_3;
+//Here, we assume that for each node, dof=1 and dof=2 are (dof=1)=(dof=0)+1 and (dof=2)=(dof=0)+2.
+//global_Edges_DOFs_Vector_Array keeps all edge dofs, which are added to the locally relevant dofs in init().
+  global_Edges_DOFs_Vector_Array.resize(3,std::vector<unsigned int>(totalNumEachEdgesNodes*12,0));
+  for(unsigned int e = 0; e < 12; e++){
+    for(unsigned int i = 0; i < totalNumEachEdgesNodes; i++){
+      const unsigned int edgeDOF0=global_Vertices_Edges_DOFs[totalNumVerticesDOFs+e*totalNumEachEdgesNodes+i];
+      for(unsigned int j = 0; j < 3; j++){
+        edges_DOFs[3*e+j][i]=edgeDOF0+j;
+        global_Edges_DOFs_Vector_Array[j][e*totalNumEachEdgesNodes+i]=edgeDOF0+j;
+      }
+    }
+  }
 
-///////////////////////Defining global dofs for Vertices End//////////////
+///////////////////////Defining global dofs for Vertices and Edges End//////////////
 
 ///////////////////////Checking the Vertices constraint lines Start//////////////
 //Here, we checked the constraint lines, if all except one dof is not defined,
@@ -525,341 +340,134 @@ void ellipticBVP<dim>::setPeriodicityConstraintsInit(){
 
 ///////////////////////Checking the Vertices constraint lines End//////////////
 
-//////////////////////Defining the global boundaryLayer2 DOFs Start/////////////////
-//The object of this function is to find   global_vector_dof_Boundary_Layer2=(all dofs for elements with a boundary face).
+//////////////////////Defining the boundaryLayer2 DOFs Start/////////////////
+//The object of this part is to find global_vector_dof_Boundary_Layer2=(all dofs for elements with a boundary face)
+//on the processors that need them, i.e. the processors which have a vertex dof in their locally relevant dofs.
 //The first step is to find the local dof_Boundary_Layer2, which is done below.
   cell = dofHandler.begin_active(), endc = dofHandler.end();
-  unsigned int CellId=0;
   for (; cell!=endc; ++cell) {
     if ((cell->is_locally_owned())&&(cell->has_boundary_lines())){
       cell->get_dof_indices (local_dof_indices);
       for (unsigned int i=0; i<dofs_per_cell; ++i) {
-        unsigned int globalDOF=local_dof_indices[i];
-        if ((!dof_Boundary_Layer2.is_element(globalDOF))&&(!vertices_DOFs.is_element(globalDOF))){
-          dof_Boundary_Layer2.add_index(globalDOF);
+        if (!vertices_DOFs.is_element(local_dof_indices[i])){
+          dof_Boundary_Layer2.add_index(local_dof_indices[i]);
         }
-        CellId=CellId+1;
-      }
-    }
-  }
-
-//Here, we search inside the dof of negative faces. If they have not been assigned to dof_Boundary_Layer2
-//before, we'll add them.
-  if (dof_FN.n_elements()>0){
-    IndexSet::ElementIterator dof_FN_counter = dof_FN.begin();
-    if (!dof_Boundary_Layer2.is_element(*dof_FN_counter)){
-      dof_Boundary_Layer2.add_index(*dof_FN_counter);
-    }
-    for(unsigned int j = 1; j < dof_FN.n_elements(); j++){
-      dof_FN_counter++;
-      if (!dof_Boundary_Layer2.is_element(*dof_FN_counter)){
-        dof_Boundary_Layer2.add_index(*dof_FN_counter);
       }
     }
   }
 
-  //Here, we gather the local dof_Boundary_Layer2 for all processors as a vector dof_Boundary_Layer2_vector which
-  //can be accessed by the processor number 0.
-  std::vector<IndexSet> dof_Boundary_Layer2_vector=Utilities::MPI::all_gather(mpi_communicator,dof_Boundary_Layer2);
-  n_processes=Utilities::MPI::n_mpi_processes(mpi_communicator);
-  global_dof_Boundary_Layer2=dof_Boundary_Layer2_vector[0];
-
-  //Here, we go over all components of dof_Boundary_Layer2_vector, which is local dof_Boundary_Layer2 for all processors
-  //and add them to a global_dof_Boundary_Layer2.
-  for (unsigned int i=1; i<n_processes; ++i) {
-    if (dof_Boundary_Layer2_vector[i].n_elements()>0){
-      IndexSet::ElementIterator dofs_boundary = dof_Boundary_Layer2_vector[i].begin();
-      if (!global_dof_Boundary_Layer2.is_element(*dofs_boundary)){
-        global_dof_Boundary_Layer2.add_index(*dofs_boundary);
-      }
-      for(unsigned int j = 1; j < dof_Boundary_Layer2_vector[i].n_elements(); j++){
-        dofs_boundary++;
-        if (!global_dof_Boundary_Layer2.is_element(*dofs_boundary)){
-          global_dof_Boundary_Layer2.add_index(*dofs_boundary);
+//Here, we add the dofs of negative faces.
+  dof_Boundary_Layer2.add_indices(dof_FN);
+  dof_Boundary_Layer2.compress();
+
+  std::vector<types::global_dof_index> local_dof_Boundary_Layer2_indices;
+  dof_Boundary_Layer2.fill_index_vector(local_dof_Boundary_Layer2_indices);
+  std::vector<unsigned int> local_vector_dof_Boundary_Layer2(local_dof_Boundary_Layer2_indices.begin(),local_dof_Boundary_Layer2_indices.end());
+
+  //The boundary layer dofs are needed by the processors which have a vertex dof in their locally relevant
+  //dofs: the owner of the cell at a corner of the domain and the processors owning a cell which shares a
+  //vertex with it (the corner cell is one of their ghost cells). The exchange only involves these processors:
+  //every processor sends its boundary layer dofs to the (at most 8) corner owners, and each corner owner
+  //forwards the collected dofs to the owners of the ghost cells around its corner cell. The senders of
+  //each step are found with compute_point_to_point_communication_pattern(), so no data of all processors
+  //is gathered anywhere.
+  std::set<unsigned int> cornerOwners;
+  for(unsigned int v=0;v<8;v++){
+    cornerOwners.insert(global_Vertices_Edges_DOFs[cornerOwnersOffset+v]);
+  }
+
+  //step 1: boundary layer dofs to the corner owners
+  std::vector<unsigned int> destinations;
+  std::vector<MPI_Request> requests;
+  if (local_vector_dof_Boundary_Layer2.size()>0){
+    for (std::set<unsigned int>::iterator p=cornerOwners.begin(); p!=cornerOwners.end(); ++p){
+      if (*p!=this_process){
+        destinations.push_back(*p);
+        requests.push_back(MPI_Request());
+        MPI_Isend(&local_vector_dof_Boundary_Layer2[0],local_vector_dof_Boundary_Layer2.size(),MPI_UNSIGNED,*p,0,mpi_communicator,&requests.back());
+      }
+    }
+  }
+  std::vector<unsigned int> sources=Utilities::MPI::compute_point_to_point_communication_pattern(mpi_communicator,destinations);
+
+  std::vector<unsigned int> collected_dof_Boundary_Layer2;
+  if (cornerOwners.count(this_process)>0){
+    collected_dof_Boundary_Layer2=local_vector_dof_Boundary_Layer2;
+    for (unsigned int i=0; i<sources.size(); ++i) {
+      MPI_Status status;
+      int count;
+      MPI_Probe(sources[i],0,mpi_communicator,&status);
+      MPI_Get_count(&status,MPI_UNSIGNED,&count);
+      std::vector<unsigned int> received_dof_Boundary_Layer2(count);
+      MPI_Recv(&received_dof_Boundary_Layer2[0],count,MPI_UNSIGNED,sources[i],0,mpi_communicator,MPI_STATUS_IGNORE);
+      collected_dof_Boundary_Layer2.insert(collected_dof_Boundary_Layer2.end(),received_dof_Boundary_Layer2.begin(),received_dof_Boundary_Layer2.end());
+    }
+    std::sort(collected_dof_Boundary_Layer2.begin(),collected_dof_Boundary_Layer2.end());
+    collected_dof_Boundary_Layer2.erase(std::unique(collected_dof_Boundary_Layer2.begin(),collected_dof_Boundary_Layer2.end()),collected_dof_Boundary_Layer2.end());
+  }
+  if (requests.size()>0){
+    MPI_Waitall(requests.size(),&requests[0],MPI_STATUSES_IGNORE);
+  }
+
+  //step 2: the corner owners forward the collected dofs to the processors around their corner cells
+  std::set<unsigned int> cornerNeighbors;
+  if (cornerOwners.count(this_process)>0){
+    std::set<unsigned int> cornerCellVertices;
+    cell = dofHandler.begin_active(), endc = dofHandler.end();
+    for (; cell!=endc; ++cell) {
+      if (cell->is_locally_owned()){
+        for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i) {
+          const unsigned int vertexDOF=cell->vertex_dof_index(i,0);
+          for(unsigned int v=0;v<8;v++){
+            if (vertexDOF==vertices_DOFs_vector[3*v]){
+              for (unsigned int j=0; j<GeometryInfo<dim>::vertices_per_cell; ++j) cornerCellVertices.insert(cell->vertex_index(j));
+            }
+          }
         }
       }
     }
-  }
-
-  //Here, we find out the number of dofs for global_dof_Boundary_Layer2 by getting the maximum of the length
-  //of global_dof_Boundary_Layer2 over all processors. Only processor rank 0 has a number and all the other ones will end up o.
-  //Accordingly, the max becomes equla to the dofs for global_dof_Boundary_Layer2 of processor 0.
-  size_dof_Boundary_Layer2=global_dof_Boundary_Layer2.n_elements();
-  global_size_dof_Boundary_Layer2=Utilities::MPI::max(size_dof_Boundary_Layer2,mpi_communicator);
-  std::vector<unsigned int> vector_dof_Boundary_Layer2;
-  vector_dof_Boundary_Layer2.resize(global_size_dof_Boundary_Layer2,0);
-  global_vector_dof_Boundary_Layer2.resize(global_size_dof_Boundary_Layer2,0);
-
-  if (size_dof_Boundary_Layer2>0){
-    IndexSet::ElementIterator global_dofs_boundary = global_dof_Boundary_Layer2.begin();
-    vector_dof_Boundary_Layer2[0]=*global_dofs_boundary;
-    for(unsigned int j = 1; j < size_dof_Boundary_Layer2; j++){
-      global_dofs_boundary++;
-      vector_dof_Boundary_Layer2[j]=*global_dofs_boundary;
-    }
-  }
-//Finally, we copy all components of global_size_dof_Boundary_Layer2 from processor rank 0 to all other processors by applying
-//the max operation. One should not for all other processors, the value is 0, after applying
-//max operator, the value of global_vector_dof_Boundary_Layer2 will be the same for all processors which is equal to the
-// dof_Boundary_Layer2 gathered from all processors.
-  for(unsigned int j = 0; j < global_size_dof_Boundary_Layer2; j++){
-    global_vector_dof_Boundary_Layer2[j]=Utilities::MPI::max(vector_dof_Boundary_Layer2[j],mpi_communicator);
-  }
-
-//////////////////////Defining the global boundaryLayer2 DOFs End/////////////////
-
-
-//////////////////////Defining the global dofs for Edges Start/////////////////
-//The object of this part is to find  global_Edges_DOFs_Vector_Array=(all dofs for on the edges).
-//The first step is to find the local dof_Boundary_Layer2, which is done below.
-
-//Edges_DOFs_1 is a indexSet we saved befor, which includes allthe dof=0 on the all edges.
-//Edges_DOFs_2 is the same for dof=1. Edges_DOFs_3 is the same for dof=2.
-  local_num_Edges_nodes=Edges_DOFs_1.n_elements();
-  if (local_num_Edges_nodes>0){
-//Edges_DOFs_Vector: is a vector which gather the dofs on the edge for the local processor for three dof of 0, 1, 2 (in 3D).
-//Edges_DOFs_Coord_Vector: is a vector that include the x,y, and z of the edge nodes for the local processor.
-    Edges_DOFs_Vector.resize(3,std::vector<unsigned int>(local_num_Edges_nodes,0));
-    Edges_DOFs_Coord_Vector.resize(3,std::vector<double>(local_num_Edges_nodes,0));
-
-    IndexSet::ElementIterator Edges_DOFs_1_counter = Edges_DOFs_1.begin();
-    IndexSet::ElementIterator Edges_DOFs_2_counter = Edges_DOFs_2.begin();
-    IndexSet::ElementIterator Edges_DOFs_3_counter = Edges_DOFs_3.begin();
-
-    Edges_DOFs_Vector[0][0]=*Edges_DOFs_1_counter;
-    Edges_DOFs_Vector[1][0]=*Edges_DOFs_2_counter;
-    Edges_DOFs_Vector[2][0]=*Edges_DOFs_3_counter;
-    node=supportPoints[*Edges_DOFs_1_counter];
-    Edges_DOFs_Coord_Vector[0][0]=node[0];
-    Edges_DOFs_Coord_Vector[1][0]=node[1];
-    Edges_DOFs_Coord_Vector[2][0]=node[2];
-
-    for(unsigned int i=1;i<local_num_Edges_nodes;i++){
-      Edges_DOFs_1_counter++;Edges_DOFs_2_counter++;Edges_DOFs_3_counter++;
-      Edges_DOFs_Vector[0][i]=*Edges_DOFs_1_counter;
-      Edges_DOFs_Vector[1][i]=*Edges_DOFs_2_counter;
-      Edges_DOFs_Vector[2][i]=*Edges_DOFs_3_counter;
-      node=supportPoints[*Edges_DOFs_1_counter];
-      Edges_DOFs_Coord_Vector[0][i]=node[0];
-      Edges_DOFs_Coord_Vector[1][i]=node[1];
-      Edges_DOFs_Coord_Vector[2][i]=node[2];
-    }
-  }
-  //Here, we gather the local Edges_DOFs_Vector and Edges_DOFs_Coord_Vector for all processors as a vector Edges_DOFs_Vector_Array and
-  // Edges_DOFs_Coord_Vector_Array which can be accessed by the processor number 0.
-  std::vector<std::vector<std::vector<unsigned int>>> Edges_DOFs_Vector_Array=Utilities::MPI::all_gather(mpi_communicator,Edges_DOFs_Vector);
-  std::vector<std::vector<std::vector<double>>> Edges_DOFs_Coord_Vector_Array=Utilities::MPI::all_gather(mpi_communicator,Edges_DOFs_Coord_Vector);
-
-  //Here, it is assumed that we are dealing with a cube with equal descritization in X, Y, and Z (totalNumEachEdgesNodes_X=totalNumEachEdgesNodes_Y=totalNumEachEdgesNodes_Z)
-  //Each cube has 12 edges->TotalNumEdgesNodes=12*totalNumEachEdgesNodes;
-  global_Edges_DOFs_Vector.resize(3,std::vector<unsigned int>(totalNumEachEdgesNodes*12,0));
-  global_Edges_DOFs_Coord_Vector.resize(3,std::vector<double>(totalNumEachEdgesNodes*12,0));
-  local_Edges_DOFs_Vector=Edges_DOFs_Vector_Array[0];
-  local_Edges_DOFs_Coord_Vector=Edges_DOFs_Coord_Vector_Array[0];
-  total_num_edges_node_processor=local_Edges_DOFs_Vector[0].size();
-  if (total_num_edges_node_processor>0){
-    for (unsigned int i=0; i<total_num_edges_node_processor; ++i) {
-      global_Edges_DOFs_Vector[0][i]=local_Edges_DOFs_Vector[0][i];
-      global_Edges_DOFs_Vector[1][i]=local_Edges_DOFs_Vector[1][i];
-      global_Edges_DOFs_Vector[2][i]=local_Edges_DOFs_Vector[2][i];
-      global_Edges_DOFs_Coord_Vector[0][i]=local_Edges_DOFs_Coord_Vector[0][i];
-      global_Edges_DOFs_Coord_Vector[1][i]=local_Edges_DOFs_Coord_Vector[1][i];
-      global_Edges_DOFs_Coord_Vector[2][i]=local_Edges_DOFs_Coord_Vector[2][i];
-    }
-  }
-
-  local_Edges_DOFs_Vector.clear();
-  local_Edges_DOFs_Coord_Vector.clear();
-
-  unsigned int num_edges_node_processor,local_edge_dof;
-  for (unsigned int i=1; i<n_processes; ++i) {
-    if (!Edges_DOFs_Vector_Array[i].empty()){
-      local_Edges_DOFs_Vector=Edges_DOFs_Vector_Array[i];
-      local_Edges_DOFs_Coord_Vector=Edges_DOFs_Coord_Vector_Array[i];
-      num_edges_node_processor=local_Edges_DOFs_Vector[0].size();
-      if (num_edges_node_processor>0){
-        for(unsigned int j = 0; j < num_edges_node_processor; j++){
-          local_edge_dof=local_Edges_DOFs_Vector[0][j];
-          if (std::count(global_Edges_DOFs_Vector[0].begin(), global_Edges_DOFs_Vector[0].end(), local_edge_dof)==0){
-            global_Edges_DOFs_Vector[0][total_num_edges_node_processor]=local_Edges_DOFs_Vector[0][j];
-            global_Edges_DOFs_Vector[1][total_num_edges_node_processor]=local_Edges_DOFs_Vector[1][j];
-            global_Edges_DOFs_Vector[2][total_num_edges_node_processor]=local_Edges_DOFs_Vector[2][j];
-            global_Edges_DOFs_Coord_Vector[0][total_num_edges_node_processor]=local_Edges_DOFs_Coord_Vector[0][j];
-            global_Edges_DOFs_Coord_Vector[1][total_num_edges_node_processor]=local_Edges_DOFs_Coord_Vector[1][j];
-            global_Edges_DOFs_Coord_Vector[2][total_num_edges_node_processor]=local_Edges_DOFs_Coord_Vector[2][j];
-            total_num_edges_node_processor=total_num_edges_node_processor+1;
+    cell = dofHandler.begin_active();
+    for (; cell!=endc; ++cell) {
+      if (cell->is_ghost()){
+        for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i) {
+          if (cornerCellVertices.count(cell->vertex_index(i))>0){
+            cornerNeighbors.insert(cell->subdomain_id());
           }
         }
       }
-      local_Edges_DOFs_Vector.clear();
-      local_Edges_DOFs_Coord_Vector.clear();
     }
+    cornerNeighbors.erase(this_process);
   }
 
-  size_dof_Edge_processor=global_Edges_DOFs_Vector[0].size();
-
-  local_Edges_DOFs_Vector.resize(3,std::vector<unsigned int>(totalNumEachEdgesNodes*12,0));
-  local_Edges_DOFs_Coord_Vector.resize(3,std::vector<double>(totalNumEachEdgesNodes*12,0));
-
-  global_Edges_DOFs_Vector_Array.resize(3,std::vector<unsigned int>(totalNumEachEdgesNodes*12,0));
-  global_Edges_DOFs_Coord_Vector_Array.resize(3,std::vector<double>(totalNumEachEdgesNodes*12,0));
-
-  if (size_dof_Edge_processor>0){
-    for(unsigned int i = 0; i < size_dof_Edge_processor; i++){
-      local_Edges_DOFs_Vector[0][i]=global_Edges_DOFs_Vector[0][i];
-      local_Edges_DOFs_Vector[1][i]=global_Edges_DOFs_Vector[1][i];
-      local_Edges_DOFs_Vector[2][i]=global_Edges_DOFs_Vector[2][i];
-      local_Edges_DOFs_Coord_Vector[0][i]=global_Edges_DOFs_Coord_Vector[0][i];
-      local_Edges_DOFs_Coord_Vector[1][i]=global_Edges_DOFs_Coord_Vector[1][i];
-      local_Edges_DOFs_Coord_Vector[2][i]=global_Edges_DOFs_Coord_Vector[2][i];
-    }
+  destinations.clear();
+  requests.clear();
+  for (std::set<unsigned int>::iterator p=cornerNeighbors.begin(); (p!=cornerNeighbors.end())&&(collected_dof_Boundary_Layer2.size()>0); ++p){
+    destinations.push_back(*p);
+    requests.push_back(MPI_Request());
+    MPI_Isend(&collected_dof_Boundary_Layer2[0],collected_dof_Boundary_Layer2.size(),MPI_UNSIGNED,*p,1,mpi_communicator,&requests.back());
   }
+  sources=Utilities::MPI::compute_point_to_point_communication_pattern(mpi_communicator,destinations);
 
-  for(unsigned int i = 0; i < (totalNumEachEdgesNodes*12); i++){
-
-    //Finally, we copy all components of global_Edges_DOFs_Vector_Array and global_Edges_DOFs_Coord_Vector_Array
-    // from processor rank 0 to all other processors by applying
-    //the max operation. One should not for all other processors, the value is 0, after applying
-    //max operator, the value of global_Edges_DOFs_Vector_Array and global_Edges_DOFs_Coord_Vector_Array
-    //will be the same for all processors which is equal to the local_Edges_DOFs_Vector and local_Edges_DOFs_Coord_Vector
-    // gathered from all processors. Here, it is assumed that all the coordinates are bigger than zero, i.e., x,y,z>=0.
-    global_Edges_DOFs_Vector_Array[0][i]=Utilities::MPI::max(local_Edges_DOFs_Vector[0][i],mpi_communicator);
-    global_Edges_DOFs_Vector_Array[1][i]=Utilities::MPI::max(local_Edges_DOFs_Vector[1][i],mpi_communicator);
-    global_Edges_DOFs_Vector_Array[2][i]=Utilities::MPI::max(local_Edges_DOFs_Vector[2][i],mpi_communicator);
-
-    global_Edges_DOFs_Coord_Vector_Array[0][i]=Utilities::MPI::max(local_Edges_DOFs_Coord_Vector[0][i],mpi_communicator);
-    global_Edges_DOFs_Coord_Vector_Array[1][i]=Utilities::MPI::max(local_Edges_DOFs_Coord_Vector[1][i],mpi_communicator);
-    global_Edges_DOFs_Coord_Vector_Array[2][i]=Utilities::MPI::max(local_Edges_DOFs_Coord_Vector[2][i],mpi_communicator);
+  global_vector_dof_Boundary_Layer2=collected_dof_Boundary_Layer2;
+  for (unsigned int i=0; i<sources.size(); ++i) {
+    MPI_Status status;
+    int count;
+    MPI_Probe(sources[i],1,mpi_communicator,&status);
+    MPI_Get_count(&status,MPI_UNSIGNED,&count);
+    std::vector<unsigned int> received_dof_Boundary_Layer2(count);
+    MPI_Recv(&received_dof_Boundary_Layer2[0],count,MPI_UNSIGNED,sources[i],1,mpi_communicator,MPI_STATUS_IGNORE);
+    global_vector_dof_Boundary_Layer2.insert(global_vector_dof_Boundary_Layer2.end(),received_dof_Boundary_Layer2.begin(),received_dof_Boundary_Layer2.end());
   }
-  //////////////////////Defining the global dofs for Edges End/////////////////
-
-  ////////////Defining the global EX000,EX001,EX010,.......... Start///////////
-  //The object of this part is to find   the global dofs for EX000,EX001,EX010,
-  //EX011, EY000,EY001,EY100,EY101, EZ000,EZ010,EZ100,EZ110 are gathered.
-  //Here, we have global_Edges_DOFs_Vector_Array from previous step as the global dofs on edges gathered from all processors.
-  //Two steps are required here: First, to define out of all global edges nodes, which ones belong to EX000,EX001,...
-  //Second: In each of the EX000, EX001,.... arrangment of nodes based on the corresponding coordinate.
-  //For example in EX000 based on the x coordinate. For EY000 based on y coordinate,
-  //and for EZ000 based on z coordinate.
-
-// EX000,EX001,.... are defined as a pair. The reason is we want to be able to arrange the nodes in them based on the coordinates.
-//Here, the second component of pair is dof0 of node, and the first component is the required coordinate for arranging the nodes.
-//We only saved the first dof (dof-0) from each node, because we know that dof=1 and dof=2 are (dof=1)=(dof=0)+1 and (dof=2)=(dof=0)+2.
-  std::vector< std::pair <double,int> > EX000,EX001,EX010,EX011;
-  std::vector< std::pair <double,int> > EY000,EY001,EY100,EY101;
-  std::vector< std::pair <double,int> > EZ000,EZ010,EZ100,EZ110;
-
-//Here, we find the dof0 belong to the nodes of each EX000,EX001,.....
-  for(unsigned int i = 0; i < (totalNumEachEdgesNodes*12); i++){
-
-    node0=global_Edges_DOFs_Coord_Vector_Array[0][i];
-    node1=global_Edges_DOFs_Coord_Vector_Array[1][i];
-    node2=global_Edges_DOFs_Coord_Vector_Array[2][i];
-
-    if ((node1 <= externalMeshParameterBCs(1))&&(node2 <= externalMeshParameterBCs(2))){
-      EX000.push_back(std::make_pair(node0,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node1 <= externalMeshParameterBCs(1))&&(node2 >= (userInputs.span[2]-externalMeshParameterBCs(2)))){
-      EX001.push_back(std::make_pair(node0,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node1 >= (userInputs.span[1]-externalMeshParameterBCs(1)))&&(node2 <= externalMeshParameterBCs(2))){
-      EX010.push_back(std::make_pair(node0,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node1 >= (userInputs.span[1]-externalMeshParameterBCs(1)))&&(node2 >= (userInputs.span[2]-externalMeshParameterBCs(2)))){
-      EX011.push_back(std::make_pair(node0,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node0 <= externalMeshParameterBCs(0))&&(node2 <= externalMeshParameterBCs(2))){
-      EY000.push_back(std::make_pair(node1,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node0 <= externalMeshParameterBCs(0))&&(node2 >= (userInputs.span[2]-externalMeshParameterBCs(2)))){
-      EY001.push_back(std::make_pair(node1,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node0 >= (userInputs.span[0]-externalMeshParameterBCs(0)))&&(node2 <= externalMeshParameterBCs(2))){
-      EY100.push_back(std::make_pair(node1,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node0 >= (userInputs.span[0]-externalMeshParameterBCs(0)))&&(node2 >= (userInputs.span[2]-externalMeshParameterBCs(2)))){
-      EY101.push_back(std::make_pair(node1,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node0 <= externalMeshParameterBCs(0))&&(node1 <= externalMeshParameterBCs(1))){
-      EZ000.push_back(std::make_pair(node2,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node0 <= externalMeshParameterBCs(0))&&(node1 >= (userInputs.span[1]-externalMeshParameterBCs(1)))){
-      EZ010.push_back(std::make_pair(node2,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node0 >= (userInputs.span[0]-externalMeshParameterBCs(0)))&&(node1 <= externalMeshParameterBCs(1))){
-      EZ100.push_back(std::make_pair(node2,global_Edges_DOFs_Vector_Array[0][i]));
-    }
-    if ((node0 >= (userInputs.span[0]-externalMeshParameterBCs(0)))&&(node1 >= (userInputs.span[1]-externalMeshParameterBCs(1)))){
-      EZ110.push_back(std::make_pair(node2,global_Edges_DOFs_Vector_Array[0][i]));
-    }
+  if (sources.size()>1){
+    std::sort(global_vector_dof_Boundary_Layer2.begin(),global_vector_dof_Boundary_Layer2.end());
+    global_vector_dof_Boundary_Layer2.erase(std::unique(global_vector_dof_Boundary_Layer2.begin(),global_vector_dof_Boundary_Layer2.end()),global_vector_dof_Boundary_Layer2.end());
   }
-
-  //Here, we sort the dof0 (second compondent of the pair) based on the cooresponding coordinates (first component of the pair)
-  std::sort(EX000.begin(), EX000.end());
-  std::sort(EX001.begin(), EX001.end());
-  std::sort(EX010.begin(), EX010.end());
-  std::sort(EX011.begin(), EX011.end());
-  std::sort(EY000.begin(), EY000.end());
-  std::sort(EY001.begin(), EY001.end());
-  std::sort(EY100.begin(), EY100.end());
-  std::sort(EY101.begin(), EY101.end());
-  std::sort(EZ000.begin(), EZ000.end());
-  std::sort(EZ010.begin(), EZ010.end());
-  std::sort(EZ100.begin(), EZ100.end());
-  std::sort(EZ110.begin(), EZ110.end());
-
-//Here, we assume that for each node, dof=1 and dof=2 are (dof=1)=(dof=0)+1 and (dof=2)=(dof=0)+2.
-  for(unsigned int i = 0; i < totalNumEachEdgesNodes; i++){
-    edges_DOFs[0][i]=EX000[i].second;
-    edges_DOFs[1][i]=EX000[i].second+1;
-    edges_DOFs[2][i]=EX000[i].second+2;
-
-    edges_DOFs[3][i]=EX001[i].second;
-    edges_DOFs[4][i]=EX001[i].second+1;
-    edges_DOFs[5][i]=EX001[i].second+2;
-
-    edges_DOFs[6][i]=EX010[i].second;
-    edges_DOFs[7][i]=EX010[i].second+1;
-    edges_DOFs[8][i]=EX010[i].second+2;
-
-    edges_DOFs[9][i]=EX011[i].second;
-    edges_DOFs[10][i]=EX011[i].second+1;
-    edges_DOFs[11][i]=EX011[i].second+2;
-
-    edges_DOFs[12][i]=EY000[i].second;
-    edges_DOFs[13][i]=EY000[i].second+1;
-    edges_DOFs[14][i]=EY000[i].second+2;
-
-    edges_DOFs[15][i]=EY001[i].second;
-    edges_DOFs[16][i]=EY001[i].second+1;
-    edges_DOFs[17][i]=EY001[i].second+2;
-
-    edges_DOFs[18][i]=EY100[i].second;
-    edges_DOFs[19][i]=EY100[i].second+1;
-    edges_DOFs[20][i]=EY100[i].second+2;
-
-    edges_DOFs[21][i]=EY101[i].second;
-    edges_DOFs[22][i]=EY101[i].second+1;
-    edges_DOFs[23][i]=EY101[i].second+2;
-
-    edges_DOFs[24][i]=EZ000[i].second;
-    edges_DOFs[25][i]=EZ000[i].second+1;
-    edges_DOFs[26][i]=EZ000[i].second+2;
-
-    edges_DOFs[27][i]=EZ010[i].second;
-    edges_DOFs[28][i]=EZ010[i].second+1;
-    edges_DOFs[29][i]=EZ010[i].second+2;
-
-    edges_DOFs[30][i]=EZ100[i].second;
-    edges_DOFs[31][i]=EZ100[i].second+1;
-    edges_DOFs[32][i]=EZ100[i].second+2;
-
-    edges_DOFs[33][i]=EZ110[i].second;
-    edges_DOFs[34][i]=EZ110[i].second+1;
-    edges_DOFs[35][i]=EZ110[i].second+2;
+  if (requests.size()>0){
+    MPI_Waitall(requests.size(),&requests[0],MPI_STATUSES_IGNORE);
   }
+  global_size_dof_Boundary_Layer2=global_vector_dof_Boundary_Layer2.size();
 
-  ////////////Defining the global EX000,EX001,EX010,.......... End///////////
+//////////////////////Defining the boundaryLayer2 DOFs End/////////////////
 }
 
 template <int dim>
@@ -1026,29 +634,11 @@ void ellipticBVP<dim>::setFaceConstraints(AffineConstraints<double>& constraintm
   double inhomogeneity_Total=0;
   unsigned int FlagDOF1,FlagDOF2,case_DOF;
 
-  unsigned int nb_dofs_face_FXN = dof_FXN.n_elements();
-  unsigned int nb_dofs_face_FYN = dof_FYN.n_elements();
-  unsigned int nb_dofs_face_FZP = dof_FZP.n_elements();
-
-
   const FEValuesExtractors::Scalar  displacementX(0);
   const FEValuesExtractors::Scalar  displacementY(1);
   const FEValuesExtractors::Scalar  displacementZ(2);
 
-  std::vector<GridTools::PeriodicFacePair<typename DoFHandler<dim>::cell_iterator> > periodicity_vectorX,periodicity_vectorY,periodicity_vectorZ;
-
-///Here, we assumed that in the face constraints lines, we always start with FXP, FYP, or FZP.
-  if (nb_dofs_face_FXN>0){
-    GridTools::collect_periodic_faces(dofHandler, /*b_id1*/ 1, /*b_id2*/ 0, /*direction*/ 0, periodicity_vectorX);
-  }
-
-  if (nb_dofs_face_FYN>0){
-    GridTools::collect_periodic_faces(dofHandler, /*b_id1*/ 3, /*b_id2*/ 2, /*direction*/ 1, periodicity_vectorY);
-  }
-
-  if (nb_dofs_face_FZP>0){
-    GridTools::collect_periodic_faces(dofHandler, /*b_id1*/ 5, /*b_id2*/ 4, /*direction*/ 2, periodicity_vectorZ);
-  }
+  //periodicity_vectorX/Y/Z are collected once in setPeriodicityConstraintsInit().
 
   // #set Faces Periodic BCs row order:
   // # 0=FXN_1;1=FXN_2;2=FXN_3; 3=FXP_1;4=FXP_2;5=FXP_3; 6=FYN_1;7=FYN_2;8=FYN_3; 9=FYP_1;10=FYP_2;11=FYP_3;
@@ -1173,80 +763,39 @@ void ellipticBVP<dim>::setFaceConstraints(AffineConstraints<double>& constraintm
 }
 
 template <int dim>
-void ellipticBVP<dim>::setPeriodicityConstraintsInc0(){
+void ellipticBVP<dim>::initPeriodicityConstraints(){
 //This functions apply all Vertices, Edges, and Faces constraint for increment 0 of each timestep.
-//This function also generate the positive loading for increment 0
-//of each timestep in the case of loading when TabularPeriodicBCs option is used.
+//The constraint structure is the same for all increments, only the inhomogeneities differ:
+//at increment 0 of each timestep they are the BCs increment (or its negative in the case of unloading
+//when TabularPeriodicBCs option is used), and in the following increments they are zero.
+//So the constraints are built and closed once here, and the closed inhomogeneities of increment 0
+//are stored to be rescaled in setPeriodicityConstraints().
 
   periodicBCsInput2=periodicBCsInput2_Orig;
 
+  constraints.clear();
+  constraints.reinit (locally_relevant_dofs_Mod);
+  DoFTools::make_hanging_node_constraints (dofHandler, constraints);
+  setFaceConstraints(constraints);
+  setEdgeConstraints(constraints);
+  setNodeConstraints(constraints);
+  constraints.close ();
 
-//The reason that increment 0 (Inc0) and the rest of increaments (IncNot0) in the case of constraints is
-//at Inc0, the nonhomegenous constraints nonequal to zero, if it
-//is available based on the constraints, should be applied as the external load.
-//However, in the following increments (IncNot0), they are just for equilibrating the residuals
-//and no nonhomogenous constraints should be added.
-  constraints_PBCs_Inc0.clear();
-  constraints_PBCs_Inc0.reinit (locally_relevant_dofs_Mod);
-  DoFTools::make_hanging_node_constraints (dofHandler, constraints_PBCs_Inc0);
-  setFaceConstraints(constraints_PBCs_Inc0);
-  setEdgeConstraints(constraints_PBCs_Inc0);
-  setNodeConstraints(constraints_PBCs_Inc0);
-  constraints_PBCs_Inc0. close ();
-}
-
-template <int dim>
-void ellipticBVP<dim>::setPeriodicityConstraintsInc0Neg(){
-//This functions apply all Vertices, Edges, and Faces constraint for increment 0
-//of each timestep in the case of unloading when TabularPeriodicBCs option is used.
-
-//Here, the BCs increment is multiplied by negative sign
-for(unsigned int i=0;i<totalNumVerticesDOFs;i++){
-  periodicBCsInput2[0][i]=-periodicBCsInput2_Orig[0][i];
-}
-
-//The reason that increment 0 (Inc0) and the rest of increaments (IncNot0) in the case of constraints is
-//at Inc0, the nonhomegenous constraints nonequal to zero, if it
-//is available based on the constraints, should be applied as the external load.
-//However, in the following increments (IncNot0), they are just for equilibrating the residuals
-//and no nonhomogenous constraints should be added.
-  constraints_PBCs_Inc0Neg.clear();
-  constraints_PBCs_Inc0Neg.reinit (locally_relevant_dofs_Mod);
-  DoFTools::make_hanging_node_constraints (dofHandler, constraints_PBCs_Inc0Neg);
-  setFaceConstraints(constraints_PBCs_Inc0Neg);
-  setEdgeConstraints(constraints_PBCs_Inc0Neg);
-  setNodeConstraints(constraints_PBCs_Inc0Neg);
-  constraints_PBCs_Inc0Neg. close ();
-}
-
-// Set constraints to enforce periodic boundary conditions
-template <int dim>
-void ellipticBVP<dim>::setPeriodicityConstraintsIncNot0(){
-  //This functions apply all Vertices, Edges, and Faces constraint for increment after 0 (IncNot0) of each timestep.
-
-  for(unsigned int i=0;i<totalNumVerticesDOFs;i++){
-    periodicBCsInput2[0][i]=0;
+  periodicInhomogeneousDOFs.clear();
+  periodicInhomogeneities.clear();
+  for (IndexSet::ElementIterator it=locally_relevant_dofs_Mod.begin(); it!=locally_relevant_dofs_Mod.end(); ++it){
+    if (constraints.is_inhomogeneously_constrained(*it)){
+      periodicInhomogeneousDOFs.push_back(*it);
+      periodicInhomogeneities.push_back(constraints.get_inhomogeneity(*it));
+    }
   }
-
-  //The reason that increment 0 (Inc0) and the rest of increaments (IncNot0) in the case of constraints is
-  //at Inc0, the nonhomegenous constraints nonequal to zero, if it
-  //is available based on the constraints, should be applied as the external load.
-  //However, in the following increments (IncNot0), they are just for equilibrating the residuals
-  //and no nonhomogenous constraints should be added.
-  constraints_PBCs_IncNot0.clear();
-  constraints_PBCs_IncNot0.reinit (locally_relevant_dofs_Mod);
-  DoFTools::make_hanging_node_constraints (dofHandler, constraints_PBCs_IncNot0);
-  setFaceConstraints(constraints_PBCs_IncNot0);
-  setEdgeConstraints(constraints_PBCs_IncNot0);
-  setNodeConstraints(constraints_PBCs_IncNot0);
-  constraints_PBCs_IncNot0. close ();
 }
 
 template <int dim>
 void ellipticBVP<dim>::setPeriodicityConstraints(){
-  constraints.clear();
-  constraints.reinit (locally_relevant_dofs_Mod);
-  DoFTools::make_hanging_node_constraints (dofHandler, constraints);
+  //loadSign: 1 for loading, -1 for unloading and 0 for neutral or for the
+  //equilibrium iterations (IncNot0), where no nonhomogenous constraints should be added.
+  double loadSign=0.0;
   if (currentIteration==0){
     if(userInputs.enableTabularPeriodicBCs){
       //I added delT/1000 as some small value to make sure we have BCs applied correct.
@@ -1259,23 +808,26 @@ void ellipticBVP<dim>::setPeriodicityConstraints(){
       }
       ////////Loading case
       if (userInputs.tabularPeriodicCoef[0][timeCounter-1]==1){
-        constraints.copy_from(constraints_PBCs_Inc0);
+        loadSign=1.0;
       }
       ////////Unloading case
       else if (userInputs.tabularPeriodicCoef[0][timeCounter-1]==-1) {
-        constraints.copy_from(constraints_PBCs_Inc0Neg);
+        loadSign=-1.0;
       }
       ////////Neutral= No Loading or Unloading
       else if (userInputs.tabularPeriodicCoef[0][timeCounter-1]==0){
-        constraints.copy_from(constraints_PBCs_IncNot0);
+        loadSign=0.0;
       }
     }
     else {
-      constraints.copy_from(constraints_PBCs_Inc0);
+      loadSign=1.0;
     }
   }
-  else{
-    constraints.copy_from(constraints_PBCs_IncNot0);
+
+  //the inhomogeneities of a full increment are scaled by the load factor of the increment, as the
+  //Dirichlet values, so a cut back or reset increment applies the reduced load
+  for (unsigned int i=0; i<periodicInhomogeneousDOFs.size(); ++i){
+    constraints.set_inhomogeneity(periodicInhomogeneousDOFs[i], loadSign*loadFactorSetByModel*periodicInhomogeneities[i]);
   }
 }
 
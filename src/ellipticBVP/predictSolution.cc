@@ -0,0 +1,50 @@
+//predictor for the first Newton iterate of an increment for ellipticBVP class
+#include "../../include/ellipticBVP.h"
+
+//With the extrapolation predictor, all dofs (including the constrained ones) are moved by the
+//displacement increment of the last converged increment (scaled by the ratio of the load factors,
+//by which both the Dirichlet and the periodic boundary increments are scaled) before the first assembly, which is suited for monotonic loading. The boundary increment is still
+//applied through the constraint inhomogeneities of the first iteration, which are then reduced by
+//the predicted increment in applyPredictionToConstraints().
+template <int dim>
+void ellipticBVP<dim>::predictSolution(){
+  solutionPredicted=false;
+  if ((!userInputs.enableExtrapolationPredictor)||(previousLoadFactor<=0.0)){
+    return;
+  }
+
+  vectorType predictedSolutionInc (locally_owned_dofs, mpi_communicator);
+  predictedSolutionInc=oldSolution;
+  predictedSolutionInc-=previousIncrementSolution;
+  predictedSolutionInc*=loadFactorSetByModel/previousLoadFactor;
+
+  solution+=predictedSolutionInc;
+  solutionWithGhosts=solution;
+  predictedSolutionIncWithGhosts.reinit (locally_owned_dofs, locally_relevant_dofs_Mod, mpi_communicator);
+  predictedSolutionIncWithGhosts=predictedSolutionInc;
+  solutionPredicted=true;
+  pcout << "extrapolated the solution from the last two converged increments\n";
+}
+
+//In the first iteration the Newton increment du of a constrained dof satisfies
+//du_i=sum_j(c_ij*du_j)+b_i with the prescribed inhomogeneity b_i. As the solution has already
+//been moved by the predicted increment dp, the remaining increment satisfies the same constraint
+//with the inhomogeneity b_i-(dp_i-sum_j(c_ij*dp_j)) (prescribed minus predicted for Dirichlet dofs).
+//The original inhomogeneities are restored by applyDirichletBCs() in the next iteration.
+template <int dim>
+void ellipticBVP<dim>::applyPredictionToConstraints(){
+  for (IndexSet::ElementIterator it=locally_relevant_dofs_Mod.begin(); it!=locally_relevant_dofs_Mod.end(); ++it){
+    const types::global_dof_index line=*it;
+    if (!constraints.is_constrained(line)) continue;
+    double constrainedPrediction=predictedSolutionIncWithGhosts(line);
+    const auto *entries=constraints.get_constraint_entries(line);
+    for (unsigned int j=0; j<entries->size(); j++){
+      constrainedPrediction-=(*entries)[j].second*predictedSolutionIncWithGhosts((*entries)[j].first);
+    }
+    if (constrainedPrediction==0.0) continue;
+    const double inhomogeneity=constraints.get_inhomogeneity(line);
+    predictorConstraintLines.push_back(std::make_pair(line, inhomogeneity));
+    constraints.set_inhomogeneity(line, inhomogeneity-constrainedPrediction);
+  }
+}
+#include "../../include/ellipticBVP_template_instantiations.h"
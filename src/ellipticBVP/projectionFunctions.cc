@@ -43,34 +43,39 @@ void ellipticBVP<dim>::initProjection(){
   massMatrix.reinit (locally_owned_dofs_Scalar, locally_owned_dofs_Scalar, dsp, mpi_communicator); massMatrix=0.0;
 
   //local variables
-  FEValues<dim> fe_values (FE_Scalar, quadrature, update_values | update_JxW_values);
+  FEValues<dim> fe_values (getMapping(), FE_Scalar, quadrature, update_values | update_JxW_values);
   const unsigned int   dofs_per_cell   = FE_Scalar.dofs_per_cell;
   FullMatrix<double>   elementalMass(dofs_per_cell, dofs_per_cell);
   std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
+  //on a uniform Cartesian mesh all cells share the elemental mass matrix of the first cell
+  bool elementalMassComputed=false;
 
   //parallel loop over all elements
   typename DoFHandler<dim>::active_cell_iterator cell = dofHandler_Scalar.begin_active(), endc = dofHandler_Scalar.end();
   unsigned int cellID=0;
   for (; cell!=endc; ++cell) {
     if (cell->is_locally_owned()){
-      elementalMass = 0;
       cell->set_user_index(cellID++);
+      if ((!uniformCartesianMesh)||(!elementalMassComputed)){
+	elementalMass = 0;
+	elementalMassComputed=true;
 
-      //compute values for the current element
-      fe_values.reinit (cell);
-
-      //elementalMass=N*N
-      for (unsigned int d1=0; d1<dofs_per_cell; ++d1) {
-	unsigned int i = fe_values.get_fe().system_to_component_index(d1).first;
-	for (unsigned int d2=0; d2<dofs_per_cell; ++d2) {
-	  unsigned int j = fe_values.get_fe().system_to_component_index(d2).first;
-	  for (unsigned int q=0; q<num_quad_points; ++q){
-	    if (i==j){
-	      if (i==0){
-		elementalMass(d1,d2)+=fe_values.shape_value(d1, q)*fe_values.shape_value(d2, q)*fe_values.JxW(q);
-	      }
-	      else{
-		elementalMass(d1,d2)=1.0;
+	//compute values for the current element
+	fe_values.reinit (cell);
+
+	//elementalMass=N*N
+	for (unsigned int d1=0; d1<dofs_per_cell; ++d1) {
+	  unsigned int i = fe_values.get_fe().system_to_component_index(d1).first;
+	  for (unsigned int d2=0; d2<dofs_per_cell; ++d2) {
+	    unsigned int j = fe_values.get_fe().system_to_component_index(d2).first;
+	    for (unsigned int q=0; q<num_quad_points; ++q){
+	      if (i==j){
+		if (i==0){
+		  elementalMass(d1,d2)+=fe_values.shape_value(d1, q)*fe_values.shape_value(d2, q)*fe_values.JxW(q);
+		}
+		else{
+		  elementalMass(d1,d2)=1.0;
+		}
 	      }
 	    }
 	  }
@@ -127,36 +132,55 @@ if (userInputs.tabularOutput){
 
   //local variables
   QGauss<dim>  quadrature(userInputs.quadOrder);
-  FEValues<dim> fe_values (FE_Scalar, quadrature, update_values | update_JxW_values);
   const unsigned int   dofs_per_cell   = FE_Scalar.dofs_per_cell;
   const unsigned int   num_quad_points = quadrature.size();
-  Vector<double>       elementalResidual (dofs_per_cell);
-  std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
-
-  //parallel loop over all elements
-  typename DoFHandler<dim>::active_cell_iterator cell = dofHandler_Scalar.begin_active(), endc = dofHandler_Scalar.end();
-  unsigned int cellID=0;
-  for (; cell!=endc; ++cell) {
-    if (cell->is_locally_owned()){
-      cell->set_user_index(cellID);
-
-      //compute values for the current element
-      fe_values.reinit (cell);
-      cell->get_dof_indices (local_dof_indices);
-      for (unsigned int field=0; field<numPostProcessedFields; field++){
-	elementalResidual = 0;
-
-	//elementalSolution=N*solution
-	for (unsigned int d1=0; d1<dofs_per_cell; ++d1) {
-	  unsigned int i = fe_values.get_fe().system_to_component_index(d1).first;
-	  for (unsigned int q=0; q<num_quad_points; ++q){
-	    elementalResidual(d1)+=fe_values.shape_value(d1, q)*postprocessValues(cellID, q, field, i)*fe_values.JxW(q);
+  std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+  getLocallyOwnedCells(dofHandler_Scalar, cells);
+  const unsigned int num_local_cells = cells.size();
+  for (unsigned int cellID=0; cellID<num_local_cells; cellID++) cells[cellID]->set_user_index(cellID);
+
+  //elemental residuals of all fields, computed by the threads over subranges of the cells
+  std::vector<double> elementalResiduals(num_local_cells*numPostProcessedFields*dofs_per_cell, 0.0);
+  parallel::apply_to_subranges(0u, num_local_cells,
+    [&](const unsigned int begin, const unsigned int end){
+      FEValues<dim> fe_values (getMapping(), FE_Scalar, quadrature, update_values | update_JxW_values);
+      //N*JxW of the current element, computed only once per subrange on a uniform Cartesian mesh
+      FullMatrix<double>   shapeValueJxW (dofs_per_cell, num_quad_points);
+      bool shapeValueJxWComputed=false;
+      for (unsigned int cellID=begin; cellID<end; cellID++){
+	//compute values for the current element
+	if ((!uniformCartesianMesh)||(!shapeValueJxWComputed)){
+	  fe_values.reinit (cells[cellID]);
+	  for (unsigned int d1=0; d1<dofs_per_cell; ++d1) {
+	    for (unsigned int q=0; q<num_quad_points; ++q){
+	      shapeValueJxW(d1,q)=fe_values.shape_value(d1, q)*fe_values.JxW(q);
+	    }
+	  }
+	  shapeValueJxWComputed=true;
+	}
+	for (unsigned int field=0; field<numPostProcessedFields; field++){
+	  double* elementalResidual=&elementalResiduals[(cellID*numPostProcessedFields+field)*dofs_per_cell];
+
+	  //elementalSolution=N*solution
+	  for (unsigned int d1=0; d1<dofs_per_cell; ++d1) {
+	    unsigned int i = FE_Scalar.system_to_component_index(d1).first;
+	    for (unsigned int q=0; q<num_quad_points; ++q){
+	      elementalResidual[d1]+=shapeValueJxW(d1,q)*postprocessValues(cellID, q, field, i);
+	    }
 	  }
 	}
-	//assemble
-	constraintsMassMatrix.distribute_local_to_global(elementalResidual, local_dof_indices, *postResidual[field]);
       }
-      cellID++;
+    }, getThreadGrainSize(num_local_cells));
+
+  //assemble (serial, the global vectors are not thread safe)
+  Vector<double>       elementalResidual (dofs_per_cell);
+  std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
+  for (unsigned int cellID=0; cellID<num_local_cells; cellID++){
+    cells[cellID]->get_dof_indices (local_dof_indices);
+    for (unsigned int field=0; field<numPostProcessedFields; field++){
+      const double* values=&elementalResiduals[(cellID*numPostProcessedFields+field)*dofs_per_cell];
+      for (unsigned int d1=0; d1<dofs_per_cell; ++d1) elementalResidual(d1)=values[d1];
+      constraintsMassMatrix.distribute_local_to_global(elementalResidual, local_dof_indices, *postResidual[field]);
     }
   }
 
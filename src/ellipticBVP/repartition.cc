@@ -0,0 +1,51 @@
+//repartitioning method for ellipticBVP class
+#include "../../include/ellipticBVP.h"
+
+//repartition the triangulation using the measured constitutive cost of each cell as its weight
+template <int dim>
+void ellipticBVP<dim>::repartition(){
+  //the periodicity constraint data is tied to the initial partition
+  if (userInputs.enablePeriodicBCs){
+    pcout << "cost weighted repartitioning is not supported with periodic BCs, skipping\n";
+    return;
+  }
+
+  computing_timer.enter_section("repartition");
+
+  //cellID of each locally owned cell before repartitioning
+  typename DoFHandler<dim>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
+  unsigned int cellID=0;
+  for (; cell!=endc; ++cell) {
+    if (cell->is_locally_owned()){
+      cell->set_user_index(cellID++);
+    }
+  }
+
+  //cell weights relative to the mean cost, on top of the base weight of 1000 per cell
+  double totalCost=0.0;
+  for (unsigned int i=0; i<cellCost.size(); i++) totalCost+=cellCost[i];
+  totalCost=Utilities::MPI::sum(totalCost, mpi_communicator);
+  const double meanCost=totalCost/triangulation.n_global_active_cells();
+  if (meanCost<=0.0){
+    computing_timer.exit_section("repartition");
+    return;
+  }
+
+  boost::signals2::connection weightConnection=triangulation.signals.cell_weight.connect(
+    [&](const typename parallel::distributed::Triangulation<dim>::cell_iterator &triaCell,
+        const typename parallel::distributed::Triangulation<dim>::CellStatus status) -> unsigned int{
+      return (unsigned int)(1000.0*cellCost[triaCell->user_index()]/meanCost);
+    });
+
+  transferToNewMesh(false);
+  weightConnection.disconnect();
+
+  const unsigned int num_local_cells=triangulation.n_locally_owned_active_cells();
+  char buffer[200];
+  sprintf(buffer, "repartitioned mesh, locally owned cells: min %u, max %u\n",
+    Utilities::MPI::min(num_local_cells, mpi_communicator), Utilities::MPI::max(num_local_cells, mpi_communicator));
+  pcout << buffer;
+
+  computing_timer.exit_section("repartition");
+}
+#include "../../include/ellipticBVP_template_instantiations.h"
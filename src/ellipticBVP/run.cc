@@ -18,6 +18,7 @@ void ellipticBVP<dim>::run(){
   initProjection();
 
   computing_timer.exit_section("mesh and initialization");
+  reportMemoryConsumption();
 
   //solve();
   solve();
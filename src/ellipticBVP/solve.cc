@@ -7,7 +7,9 @@ void ellipticBVP<dim>::solve(){
   pcout << "begin solve...\n\n";
 
   //load increments
-  unsigned int successiveIncs=0;
+  unsigned int successiveIncs=0, successiveCutbacks=0;
+  //the history of the material model is allocated in the first increment
+  bool memoryReported=false;
 
   if(userInputs.enableAdaptiveTimeStepping){
     for (;totalLoadFactor<totalIncrements;){
@@ -27,15 +29,21 @@ void ellipticBVP<dim>::solve(){
       //call updateAfterIncrement, if any
       if (success){
         updateAfterIncrement();
+        if ((userInputs.writeMemoryReportPerIncrement)||(!memoryReported)){
+          reportMemoryConsumption();
+          memoryReported=true;
+        }
 
         //update totalLoadFactor
         totalLoadFactor+=loadFactorSetByModel;
 
-        //increase loadFactorSetByModel, if succesiveIncForIncreasingTimeStep satisfied.
+        //increase loadFactorSetByModel (up to the nominal increment), if succesiveIncForIncreasingTimeStep satisfied.
         successiveIncs++;
+        successiveCutbacks=0;
 
-        if (successiveIncs>=userInputs.succesiveIncForIncreasingTimeStep){
-          loadFactorSetByModel*=userInputs.adaptiveLoadIncreaseFactor;
+        if ((successiveIncs>=userInputs.succesiveIncForIncreasingTimeStep)&&(loadFactorSetByModel<1.0)){
+          loadFactorSetByModel=std::min(1.0, loadFactorSetByModel*userInputs.adaptiveLoadIncreaseFactor);
+          successiveIncs=0;
           char buffer1[100];
         	sprintf(buffer1, "current increment increased. Restarting increment with loadFactorSetByModel: %12.6e\n", loadFactorSetByModel);
         	pcout << buffer1;
@@ -46,9 +54,21 @@ void ellipticBVP<dim>::solve(){
         if (currentIncrement%userInputs.skipOutputSteps==0)
           if (userInputs.writeOutput) output();
         computing_timer.exit_section("postprocess");
+
+        if ((userInputs.enableAdaptiveRefinement)&&(currentIncrement%userInputs.adaptiveRefinementInterval==0))
+          adaptMesh();
+        if ((userInputs.enableCostWeightedRepartition)&&(currentIncrement%userInputs.repartitionInterval==0))
+          repartition();
         }
       else{
+        //the increment is repeated with the reduced loadFactorSetByModel
+        --currentIncrement;
         successiveIncs=0;
+        successiveCutbacks++;
+        if (successiveCutbacks>userInputs.maxIncrementCutbacks){
+          pcout << "maximum number of successive increment cutbacks reached\n";
+          exit(1);
+        }
       }
     }
     char buffer[100];
@@ -67,6 +87,10 @@ void ellipticBVP<dim>::solve(){
     //call updateAfterIncrement, if any
     if (success){
       updateAfterIncrement();
+      if ((userInputs.writeMemoryReportPerIncrement)||(!memoryReported)){
+        reportMemoryConsumption();
+        memoryReported=true;
+      }
 
       //update totalLoadFactor
       totalLoadFactor+=loadFactorSetByModel;
@@ -97,6 +121,11 @@ void ellipticBVP<dim>::solve(){
         if (userInputs.writeOutput) output();
       }
       computing_timer.exit_section("postprocess");
+
+      if ((userInputs.enableAdaptiveRefinement)&&((currentIncrement+1)%userInputs.adaptiveRefinementInterval==0))
+        adaptMesh();
+      if ((userInputs.enableCostWeightedRepartition)&&((currentIncrement+1)%userInputs.repartitionInterval==0))
+        repartition();
       }
     else{
       successiveIncs=0;
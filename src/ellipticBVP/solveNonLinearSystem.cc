@@ -10,7 +10,25 @@ bool ellipticBVP<dim>::solveNonLinearSystem(){
   //non linear iterations
   char buffer[200];
   currentIteration=0;
-  while (currentIteration < userInputs.maxNonLinearIterations){
+
+  //initial guess for the first Newton iterate of this increment
+  predictSolution();
+
+  //the iterations end early once a (positive) tolerance is met only if the convergence check is
+  //enabled, otherwise maxNonLinearIterations iterations are always performed. The residual after the
+  //last iteration is tested if the convergence check or adaptive time stepping is enabled, so a
+  //non-converged increment is cut back with adaptive time stepping.
+  const bool hasTolerance=(userInputs.absNonLinearTolerance>0)||(userInputs.relNonLinearTolerance>0);
+  const bool checkConvergence=(userInputs.enableNonLinearConvergenceCheck)&&(hasTolerance);
+  const bool checkFinalConvergence=(hasTolerance)&&((checkConvergence)||(userInputs.enableAdaptiveTimeStepping));
+  bool converged=false, diverged=false;
+
+  //with inexact local tolerances, the material point tolerances of an iteration are loosened in
+  //proportion to the residual of the previous iteration (at most by maxLocalToleranceFactor). An
+  //iteration which meets the convergence criteria with loosened tolerances is repeated at the same
+  //solution with the strict tolerances, so the converged state always satisfies them.
+  localToleranceFactor=1.0;
+  while ((currentIteration < userInputs.maxNonLinearIterations)||((checkFinalConvergence)&&(currentIteration==userInputs.maxNonLinearIterations))){
     //call updateBeforeIteration, if any
     updateBeforeIteration();
 
@@ -24,33 +42,98 @@ bool ellipticBVP<dim>::solveNonLinearSystem(){
     }
     computing_timer.exit_section("assembly");
 
-    if (!resetIncrement){
-      //Calculate residual norms and check for convergence
-      currentNorm=residual.l2_norm();
-      initialNorm=std::max(initialNorm, currentNorm);
-      relNorm=currentNorm/initialNorm;
-      //print iteration information
-      sprintf(buffer,
-        "nonlinear iteration %3u [current residual: %8.2e, initial residual: %8.2e, relative residual: %8.2e]\n",
-        currentIteration,
-        currentNorm,
-        initialNorm,
-        relNorm);
-        pcout << buffer;
-        //if not converged, solveLinearSystem Ax=b
-        computing_timer.enter_section("solve");
-        solveLinearSystem(constraints, jacobian, residual, solution, solutionWithGhosts, solutionIncWithGhosts);
-        computing_timer.exit_section("solve");
-        currentIteration++;
+    //increment reset by the model during assembly
+    if (resetIncrement){
+      break;
+    }
+
+    //Calculate residual norms and check for convergence
+    currentNorm=residual.l2_norm();
+    initialNorm=std::max(initialNorm, currentNorm);
+    relNorm=currentNorm/initialNorm;
+    //print iteration information
+    sprintf(buffer,
+      "nonlinear iteration %3u [current residual: %8.2e, initial residual: %8.2e, relative residual: %8.2e]\n",
+      currentIteration,
+      currentNorm,
+      initialNorm,
+      relNorm);
+    pcout << buffer;
+
+    if (!std::isfinite(currentNorm)){
+      diverged=true;
+      break;
+    }
+    //the last pass only assembles the residual of the final solution for the convergence test
+    const bool lastIteration=(currentIteration==userInputs.maxNonLinearIterations);
+    if (((checkConvergence)||(lastIteration))&&(currentIteration>0)&&((currentNorm<userInputs.absNonLinearTolerance)||(relNorm<userInputs.relNonLinearTolerance))){
+      if (localToleranceFactor>1.0){
+        localToleranceFactor=1.0;
+        pcout << "reassembling with the strict material point tolerances\n";
+        continue;
       }
-      //call updateAfterIteration, if any
-      updateAfterIteration();
+      converged=true;
+      break;
+    }
+    if (lastIteration){
+      break;
     }
 
-    //check if maxNonLinearIterations reached
+    //if not converged, solveLinearSystem Ax=b
+    computing_timer.enter_section("solve");
+    solveLinearSystem(constraints, jacobian, residual, solution, solutionWithGhosts, solutionIncWithGhosts);
+    computing_timer.exit_section("solve");
+    currentIteration++;
 
-    //update old solution to new converged solution
-    oldSolution=solution;
-    return true;
+    //the strict tolerances are only restored at convergence, so the tolerances are not loosened without convergence check
+    if ((checkConvergence)&&(userInputs.enableInexactLocalTolerance)){
+      double ratio=1.0;
+      if (userInputs.relNonLinearTolerance>0) ratio=relNorm/userInputs.relNonLinearTolerance;
+      else if (userInputs.absNonLinearTolerance>0) ratio=currentNorm/userInputs.absNonLinearTolerance;
+      localToleranceFactor=std::min(userInputs.maxLocalToleranceFactor, std::max(1.0, ratio));
+    }
+
+    //call updateAfterIteration, if any
+    updateAfterIteration();
   }
-  #include "../../include/ellipticBVP_template_instantiations.h"
+
+  //check if maxNonLinearIterations reached
+  if ((checkFinalConvergence)&&(!converged)&&(!resetIncrement)&&(!diverged)){
+    if (userInputs.enableAdaptiveTimeStepping){
+      diverged=true;
+    }
+    else if (userInputs.stopOnConvergenceFailure){
+      pcout << "nonlinear solver did not converge. Consider using a smaller load increment or enabling adaptive time stepping.\n";
+      exit(1);
+    }
+    else{
+      pcout << "nonlinear solver did not converge, stopOnConvergenceFailure==false, so marching ahead\n";
+    }
+  }
+
+  //roll back the solution and the history of the model to the last converged increment
+  if ((resetIncrement)||(diverged)){
+    //the boundary conditions are incremental, so with fixed increments a failed increment
+    //can not be skipped and is not repeated with the same load
+    if (!userInputs.enableAdaptiveTimeStepping){
+      pcout << "increment failed (non-finite residual or increment reset by the model). Consider using a smaller load increment or enabling adaptive time stepping.\n";
+      exit(1);
+    }
+    if (diverged){
+      double cutbackFactor=userInputs.adaptiveLoadStepFactor;
+      if ((cutbackFactor<=0.0)||(cutbackFactor>=1.0)) cutbackFactor=0.5;
+      loadFactorSetByModel*=cutbackFactor;
+    }
+    resetIncrement=true;
+    resetIncrementHistory();
+    testConvergenceAfterIteration();
+    return false;
+  }
+
+  //update old solution to new converged solution
+  previousIncrementSolution=oldSolution;
+  oldSolution=solution;
+  previousLoadFactor=loadFactorSetByModel;
+  return true;
+}
+#include "../../include/ellipticBVP_template_instantiations.h"
@@ -0,0 +1,25 @@
+//helper methods for the thread-parallel cell loops of the ellipticBVP class
+#include "../../include/ellipticBVP.h"
+
+//locally owned cells in the order of their cellID, so that the cellIDs of a loop
+//can be split into subranges processed by different threads. Only the post-processing loops
+//are threaded: calculatePlasticity() keeps its scratch state in members of the material model,
+//so the constitutive update and the assembly loop over the cells serially.
+template <int dim>
+void ellipticBVP<dim>::getLocallyOwnedCells(const DoFHandler<dim>& _dofHandler, std::vector<typename DoFHandler<dim>::active_cell_iterator>& cells) const{
+  cells.clear();
+  cells.reserve(triangulation.n_locally_owned_active_cells());
+  typename DoFHandler<dim>::active_cell_iterator cell = _dofHandler.begin_active(), endc = _dofHandler.end();
+  for (; cell!=endc; ++cell) {
+    if (cell->is_locally_owned()){
+      cells.push_back(cell);
+    }
+  }
+}
+
+//about four subranges per thread, to balance cells of different cost
+template <int dim>
+unsigned int ellipticBVP<dim>::getThreadGrainSize(unsigned int numItems) const{
+  return std::max(1u, numItems/(4*MultithreadInfo::n_threads()));
+}
+#include "../../include/ellipticBVP_template_instantiations.h"
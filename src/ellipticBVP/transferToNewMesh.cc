@@ -0,0 +1,211 @@
+//mesh change method for ellipticBVP class
+#include "../../include/ellipticBVP.h"
+
+//repartition (or refine and coarsen the flagged cells of) the triangulation, migrate the quadrature
+//point history of the material model and the converged solutions with the cells, and reinitialize
+//the FE data structures on the new mesh
+template <int dim>
+void ellipticBVP<dim>::transferToNewMesh(bool refineAndCoarsen){
+  typedef typename parallel::distributed::Triangulation<dim>::cell_iterator triaCellIterator;
+  typedef typename parallel::distributed::Triangulation<dim>::CellStatus triaCellStatus;
+
+  //quadrature point maps between a parent cell and its children (nearest quadrature point)
+  QGauss<dim>  quadrature(userInputs.quadOrder);
+  const unsigned int num_quad_points = quadrature.size();
+  std::vector<std::vector<unsigned int> > childToParentQuadPt(GeometryInfo<dim>::max_children_per_cell, std::vector<unsigned int>(num_quad_points));
+  std::vector<std::pair<unsigned int,unsigned int> > parentToChildQuadPt(num_quad_points);
+  for (unsigned int q=0; q<num_quad_points; q++){
+    for (unsigned int c=0; c<GeometryInfo<dim>::max_children_per_cell; c++){
+      const Point<dim> parentPoint=GeometryInfo<dim>::child_to_cell_coordinates(quadrature.point(q), c);
+      unsigned int nearest=0;
+      for (unsigned int q2=1; q2<num_quad_points; q2++){
+        if (parentPoint.distance(quadrature.point(q2))<parentPoint.distance(quadrature.point(nearest))) nearest=q2;
+      }
+      childToParentQuadPt[c][q]=nearest;
+    }
+    const unsigned int c=GeometryInfo<dim>::child_cell_from_point(quadrature.point(q));
+    const Point<dim> childPoint=GeometryInfo<dim>::cell_to_child_coordinates(quadrature.point(q), c);
+    unsigned int nearest=0;
+    for (unsigned int q2=1; q2<num_quad_points; q2++){
+      if (childPoint.distance(quadrature.point(q2))<childPoint.distance(quadrature.point(nearest))) nearest=q2;
+    }
+    parentToChildQuadPt[q]=std::make_pair(c,nearest);
+  }
+  std::vector<unsigned int> identityQuadPt(num_quad_points);
+  for (unsigned int q=0; q<num_quad_points; q++) identityQuadPt[q]=q;
+
+  //cellID of each locally owned cell before the mesh change
+  typename DoFHandler<dim>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
+  unsigned int cellID=0;
+  for (; cell!=endc; ++cell) {
+    if (cell->is_locally_owned()){
+      cell->set_user_index(cellID++);
+    }
+  }
+
+  //sources of the packed history: the cell itself, or the children of a cell to be coarsened
+  auto packCell=[&](const triaCellIterator &triaCell, const triaCellStatus status, std::vector<double>& values){
+    std::vector<std::pair<unsigned int,unsigned int> > sources(num_quad_points);
+    for (unsigned int q=0; q<num_quad_points; q++){
+      if (status==parallel::distributed::Triangulation<dim>::CELL_COARSEN)
+      sources[q]=std::make_pair(triaCell->child(parentToChildQuadPt[q].first)->user_index(), parentToChildQuadPt[q].second);
+      else
+      sources[q]=std::make_pair(triaCell->user_index(), q);
+    }
+    packCellData(sources, values);
+  };
+
+  //the packed history is copied to the cell itself, or to each child of a refined cell
+  auto unpackCell=[&](const triaCellIterator &triaCell, const triaCellStatus status, const std::vector<double>& values){
+    if (status==parallel::distributed::Triangulation<dim>::CELL_REFINE){
+      for (unsigned int c=0; c<triaCell->n_children(); c++){
+        unpackCellData(triaCell->child(c)->user_index(), childToParentQuadPt[c], values);
+      }
+    }
+    else if (status!=parallel::distributed::Triangulation<dim>::CELL_INVALID){
+      unpackCellData(triaCell->user_index(), identityQuadPt, values);
+    }
+  };
+
+#if ((DEAL_II_VERSION_MAJOR < 9)||(DEAL_II_VERSION_MINOR < 1))
+  //fixed size buffer, sized to the largest history of any cell
+  std::vector<double> cellData;
+  unsigned int maxCellDataSize=0;
+  for (cell=dofHandler.begin_active(); cell!=endc; ++cell) {
+    if (cell->is_locally_owned()){
+      cellData.clear();
+      packCell(cell, parallel::distributed::Triangulation<dim>::CELL_PERSIST, cellData);
+      maxCellDataSize=std::max(maxCellDataSize, (unsigned int)cellData.size());
+    }
+  }
+  maxCellDataSize=Utilities::MPI::max(maxCellDataSize, mpi_communicator);
+
+  const unsigned int dataHandle=triangulation.register_data_attach((maxCellDataSize+1)*sizeof(double),
+    [&](const triaCellIterator &triaCell, const triaCellStatus status, void* data){
+      std::vector<double> values;
+      packCell(triaCell, status, values);
+      double* buffer=static_cast<double*>(data);
+      buffer[0]=values.size();
+      std::copy(values.begin(), values.end(), buffer+1);
+    });
+#else
+  const unsigned int dataHandle=triangulation.register_data_attach(
+    [&](const triaCellIterator &triaCell, const triaCellStatus status) -> std::vector<char>{
+      std::vector<double> values;
+      packCell(triaCell, status, values);
+      return Utilities::pack(values, false);
+    }, true);
+#endif
+
+  //converged solutions are interpolated to the new mesh (solution==oldSolution after an increment)
+  vectorType oldSolutionWithGhosts(locally_owned_dofs, locally_relevant_dofs, mpi_communicator);
+  vectorType previousIncrementSolutionWithGhosts(locally_owned_dofs, locally_relevant_dofs, mpi_communicator);
+  oldSolutionWithGhosts=oldSolution;
+  previousIncrementSolutionWithGhosts=previousIncrementSolution;
+  std::vector<const vectorType*> solutionsToTransfer;
+  solutionsToTransfer.push_back(&oldSolutionWithGhosts);
+  solutionsToTransfer.push_back(&previousIncrementSolutionWithGhosts);
+  parallel::distributed::SolutionTransfer<dim, vectorType> solutionTransfer(dofHandler);
+  solutionTransfer.prepare_for_coarsening_and_refinement(solutionsToTransfer);
+
+  if (refineAndCoarsen) triangulation.execute_coarsening_and_refinement();
+  else triangulation.repartition();
+
+  //cellID of each locally owned cell after the mesh change
+  const unsigned int num_local_cells=triangulation.n_locally_owned_active_cells();
+  cellID=0;
+  for (cell=dofHandler.begin_active(); cell!=endc; ++cell) {
+    if (cell->is_locally_owned()){
+      cell->set_user_index(cellID++);
+    }
+  }
+  resizeCellData(num_local_cells);
+
+#if ((DEAL_II_VERSION_MAJOR < 9)||(DEAL_II_VERSION_MINOR < 1))
+  triangulation.notify_ready_to_unpack(dataHandle,
+    [&](const triaCellIterator &triaCell, const triaCellStatus status, const void* data){
+      const double* buffer=static_cast<const double*>(data);
+      const unsigned int size=(unsigned int)buffer[0];
+      std::vector<double> values(buffer+1, buffer+1+size);
+      unpackCell(triaCell, status, values);
+    });
+#else
+  triangulation.notify_ready_to_unpack(dataHandle,
+    [&](const triaCellIterator &triaCell, const triaCellStatus status,
+        const boost::iterator_range<std::vector<char>::const_iterator> &data){
+      std::vector<double> values=Utilities::unpack<std::vector<double> >(data.begin(), data.end(), false);
+      unpackCell(triaCell, status, values);
+    });
+#endif
+
+  //redistribute the FE objects on the new mesh
+  dofHandler.distribute_dofs (FE);
+  locally_owned_dofs = dofHandler.locally_owned_dofs ();
+  DoFTools::extract_locally_relevant_dofs (dofHandler, locally_relevant_dofs);
+  locally_relevant_dofs_Mod=locally_relevant_dofs;
+
+  dofHandler_Scalar.distribute_dofs (FE_Scalar);
+  locally_owned_dofs_Scalar = dofHandler_Scalar.locally_owned_dofs ();
+  DoFTools::extract_locally_relevant_dofs (dofHandler_Scalar, locally_relevant_dofs_Scalar);
+
+  constraintsMassMatrix.clear ();
+  constraintsMassMatrix.reinit (locally_relevant_dofs_Scalar);
+  DoFTools::make_hanging_node_constraints (dofHandler_Scalar, constraintsMassMatrix);
+  constraintsMassMatrix.close ();
+
+  checkUniformCartesianMesh();
+
+  supportPoints.clear();
+  DoFTools::map_dofs_to_support_points(MappingQ1<dim, dim>(), dofHandler, supportPoints);
+
+  //constraints (hanging nodes and the dirichlet DOFs of the new mesh)
+  initDirichletBCs();
+
+  //global data structures
+  solution.reinit (locally_owned_dofs, mpi_communicator);
+  oldSolution.reinit (locally_owned_dofs, mpi_communicator);
+  previousIncrementSolution.reinit (locally_owned_dofs, mpi_communicator);
+  std::vector<vectorType*> transferredSolutions;
+  transferredSolutions.push_back(&oldSolution);
+  transferredSolutions.push_back(&previousIncrementSolution);
+  solutionTransfer.interpolate(transferredSolutions);
+
+  //make the transferred solutions conforming at the hanging nodes
+#if ((DEAL_II_VERSION_MAJOR < 9)||(DEAL_II_VERSION_MINOR < 1))
+  ConstraintMatrix hangingNodeConstraints;
+#else
+  AffineConstraints<double> hangingNodeConstraints;
+#endif
+  hangingNodeConstraints.reinit (locally_relevant_dofs);
+  DoFTools::make_hanging_node_constraints (dofHandler, hangingNodeConstraints);
+  hangingNodeConstraints.close ();
+  hangingNodeConstraints.distribute (oldSolution);
+  hangingNodeConstraints.distribute (previousIncrementSolution);
+
+  solution=oldSolution;
+  solutionWithGhosts.reinit (locally_owned_dofs, locally_relevant_dofs_Mod, mpi_communicator); solutionWithGhosts=solution;
+  solutionIncWithGhosts.reinit (locally_owned_dofs, locally_relevant_dofs_Mod, mpi_communicator); solutionIncWithGhosts=0;
+  residual.reinit (locally_owned_dofs, mpi_communicator); residual=0;
+
+  DynamicSparsityPattern dsp (locally_relevant_dofs_Mod);
+  DoFTools::make_sparsity_pattern (dofHandler, dsp, constraints, false);
+  SparsityTools::distribute_sparsity_pattern (dsp,
+    dofHandler.n_locally_owned_dofs_per_processor(),
+    mpi_communicator,
+    locally_relevant_dofs_Mod);
+  jacobian.reinit (locally_owned_dofs, locally_owned_dofs, dsp, mpi_communicator);
+
+  //post processing data structures
+  for (unsigned int field=0; field<postResidual.size(); field++){
+    delete postResidual[field];
+    delete postFields[field];
+    delete postFieldsWithGhosts[field];
+  }
+  postResidual.clear(); postFields.clear(); postFieldsWithGhosts.clear();
+  initProjection();
+
+  if (userInputs.enableCostWeightedRepartition){
+    cellCost.assign(num_local_cells,0.0);
+  }
+}
+#include "../../include/ellipticBVP_template_instantiations.h"
@@ -0,0 +1,51 @@
+#include "../../../include/crystalPlasticity.h"
+
+namespace {
+  //bytes of a per quadrature point field (zero if the field is not allocated for the current model)
+  template <typename T>
+  void addEntry(std::vector<std::pair<std::string,std::size_t> >& entries, const std::string& name, const std::vector<T>& field){
+    entries.push_back(std::make_pair(name, (field.size()>0) ? MemoryConsumption::memory_consumption(field) : 0));
+  }
+
+  void addEntry(std::vector<std::pair<std::string,std::size_t> >& entries, const std::string& name, const quadratureHistory& field){
+    entries.push_back(std::make_pair(name, field.memory_consumption()));
+  }
+}
+
+//history arrays, quadrature output and orientation tables of the crystal plasticity model
+template <int dim>
+void crystalPlasticity<dim>::addMemoryConsumption(std::vector<std::pair<std::string,std::size_t> >& entries)
+{
+  addEntry(entries, "Fe_conv", Fe_conv); addEntry(entries, "Fe_iter", Fe_iter);
+  addEntry(entries, "Fp_conv", Fp_conv); addEntry(entries, "Fp_iter", Fp_iter);
+  addEntry(entries, "s_alpha_conv", s_alpha_conv); addEntry(entries, "s_alpha_iter", s_alpha_iter);
+  addEntry(entries, "W_kh_conv", W_kh_conv); addEntry(entries, "W_kh_iter", W_kh_iter);
+  addEntry(entries, "rot_conv", rot_conv); addEntry(entries, "rot_iter", rot_iter);
+  addEntry(entries, "rotnew_conv", rotnew_conv); addEntry(entries, "rotnew_iter", rotnew_iter);
+  addEntry(entries, "rot", rot);
+  addEntry(entries, "twinfraction_conv", twinfraction_conv); addEntry(entries, "twinfraction_iter", twinfraction_iter);
+  addEntry(entries, "slipfraction_conv", slipfraction_conv); addEntry(entries, "slipfraction_iter", slipfraction_iter);
+  addEntry(entries, "slipIncrement_iter", slipIncrement_iter);
+  addEntry(entries, "twin_conv", twin_conv); addEntry(entries, "twin_iter", twin_iter);
+  addEntry(entries, "twin_ouput", twin_ouput);
+  addEntry(entries, "phase", phase);
+  addEntry(entries, "CauchyStress", CauchyStress);
+  addEntry(entries, "TinterStress", TinterStress);
+  addEntry(entries, "TinterStress_diff", TinterStress_diff);
+  addEntry(entries, "stateVar_conv", stateVar_conv); addEntry(entries, "stateVar_iter", stateVar_iter);
+  addEntry(entries, "VoxelData", VoxelData);
+  addEntry(entries, "TwinMaxFlag_conv", TwinMaxFlag_conv); addEntry(entries, "TwinMaxFlag_iter", TwinMaxFlag_iter);
+  addEntry(entries, "NumberOfTwinnedRegion_conv", NumberOfTwinnedRegion_conv); addEntry(entries, "NumberOfTwinnedRegion_iter", NumberOfTwinnedRegion_iter);
+  addEntry(entries, "ActiveTwinSystems_conv", ActiveTwinSystems_conv); addEntry(entries, "ActiveTwinSystems_iter", ActiveTwinSystems_iter);
+  addEntry(entries, "TwinFlag_conv", TwinFlag_conv); addEntry(entries, "TwinFlag_iter", TwinFlag_iter);
+  addEntry(entries, "TwinOutputfraction_conv", TwinOutputfraction_conv); addEntry(entries, "TwinOutputfraction_iter", TwinOutputfraction_iter);
+  addEntry(entries, "TotaltwinvfK", TotaltwinvfK);
+
+  addEntry(entries, "outputQuadrature", outputQuadrature);
+  entries.push_back(std::make_pair("grain averaged sums", MemoryConsumption::memory_consumption(local_grainSums)+MemoryConsumption::memory_consumption(global_grainSums)));
+  entries.push_back(std::make_pair("cell orientation map", MemoryConsumption::memory_consumption(cellOrientationMap)));
+  //voxel and orientation tables, shared by the processes of a node
+  entries.push_back(std::make_pair("orientation/voxel tables", orientations.memory_consumption()));
+}
+
+#include "../../../include/crystalPlasticity_template_instantiations.h"
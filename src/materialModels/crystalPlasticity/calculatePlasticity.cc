@@ -9,8 +9,110 @@
 //calculatePlasticity.cc available in plasticity/src/materialModels/crystalPlasticity/MaterialModels/RateIndependentModel folder.
 //////////////////////////////////////////////////////////////////////////
 
+namespace {
+  //Voigt index of the symmetric component (a,b) and the component pair of each Voigt index,
+  //in the ordering of the elastic moduli Dmat2 (11,22,33,23,13,12)
+  const unsigned int voigtIndex[3][3]={{0,5,4},{5,1,3},{4,3,2}};
+  const unsigned int voigtPair[6][2]={{0,0},{1,1},{2,2},{1,2},{0,2},{0,1}};
+
+  //delFe_delF of Fe=F*inv(Fp), from delFp_delF: column kl is e_k*e_l^T*inv(Fp)-Fe*(delFp/delF_kl)*inv(Fp)
+  void elasticDeformationGradientDerivative(const FullMatrix<double> &FE, const FullMatrix<double> &Fpn_inv,
+    const FullMatrix<double> &delFp_delF, FullMatrix<double> &delFe_delF){
+    const unsigned int n=FE.m();
+    std::vector<double> G(n*n);
+    for (unsigned int k=0;k<n;k++){
+      for (unsigned int l=0;l<n;l++){
+        const unsigned int kl=n*k+l;
+        for (unsigned int i=0;i<n;i++){
+          for (unsigned int b=0;b<n;b++){
+            G[n*i+b]=0.0;
+            for (unsigned int a=0;a<n;a++) G[n*i+b]+=FE(i,a)*delFp_delF(n*a+b,kl);
+          }
+        }
+        for (unsigned int i=0;i<n;i++){
+          for (unsigned int j=0;j<n;j++){
+            double value=(i==k) ? Fpn_inv(l,j) : 0.0;
+            for (unsigned int b=0;b<n;b++) value-=G[n*i+b]*Fpn_inv(b,j);
+            delFe_delF(n*i+j,kl)=value;
+          }
+        }
+      }
+    }
+  }
+
+  //stress column of the elastic moduli (minor symmetries) applied to the symmetric strain column E,
+  //using only its 6 independent components
+  void voigtStress(const FullMatrix<double> &Dmat2, const double E[6], double T[3][3]){
+    double strain[6], stress[6];
+    for (unsigned int v=0;v<6;v++) strain[v]=(v<3) ? E[v] : 2.0*E[v];
+    for (unsigned int v=0;v<6;v++){
+      stress[v]=0.0;
+      for (unsigned int w=0;w<6;w++) stress[v]+=Dmat2(v,w)*strain[w];
+    }
+    for (unsigned int a=0;a<3;a++)
+    for (unsigned int b=0;b<3;b++) T[a][b]=stress[voigtIndex[a][b]];
+  }
+
+  //The tangent modulus is assembled column by column (k,l) directly into dP_dF, as
+  //dP = dFe*temp1 + FE*dT*temp2^T - temp3*dFe*temp4^T - temp6(i,l)*temp4(j,k), where dT is the
+  //(symmetric) derivative of T_star_tau from the 6 independent components of sym(FE^T*dFe)
+  template <int dim>
+  void assembleTangentModulus(const FullMatrix<double> &F_tau, const FullMatrix<double> &FE_tau,
+    const FullMatrix<double> &T_star_tau, const FullMatrix<double> &Dmat2, const FullMatrix<double> &delFe_delF,
+    Tensor<4,dim,double> &dP_dF){
+    FullMatrix<double> temp(dim,dim),temp1(dim,dim),temp2(dim,dim),temp3(dim,dim),temp4(dim,dim),temp5(dim,dim),temp6(dim,dim);
+    temp4.invert(F_tau);
+    temp4.mmult(temp,FE_tau);
+    T_star_tau.mTmult(temp1,temp);
+    temp4.mmult(temp2,FE_tau); // Transpose the matrix
+    FE_tau.mmult(temp3,T_star_tau);
+    temp3.mTmult(temp5,F_tau);
+    temp5.mTmult(temp6,temp4);
+
+    double dFe[3][3], E[6], dT[3][3], X[3][3], Y[3][3];
+    for (unsigned int k=0;k<dim;k++){
+      for (unsigned int l=0;l<dim;l++){
+        for (unsigned int a=0;a<dim;a++){
+          for (unsigned int b=0;b<dim;b++){
+            dFe[a][b]=delFe_delF(3*(a)+b,3*(k)+l);
+          }
+        }
+
+        for (unsigned int v=0;v<6;v++){
+          const unsigned int a=voigtPair[v][0], b=voigtPair[v][1];
+          E[v]=0.0;
+          for (unsigned int c=0;c<dim;c++){
+            E[v]=E[v]+0.5*(dFe[c][a]*FE_tau(c,b)+dFe[c][b]*FE_tau(c,a));
+          }
+        }
+        voigtStress(Dmat2,E,dT);
+
+        for (unsigned int i=0;i<dim;i++){
+          for (unsigned int j=0;j<dim;j++){
+            X[i][j]=0.0; Y[i][j]=0.0;
+            for (unsigned int a=0;a<dim;a++){
+              X[i][j]=X[i][j]+FE_tau(i,a)*dT[a][j];
+              Y[i][j]=Y[i][j]+dFe[i][a]*temp4(j,a);
+            }
+          }
+        }
+
+        for (unsigned int i=0;i<dim;i++){
+          for (unsigned int j=0;j<dim;j++){
+            double value=-temp6(i,l)*temp4(j,k);
+            for (unsigned int a=0;a<dim;a++){
+              value=value+dFe[i][a]*temp1(a,j)+X[i][a]*temp2(j,a)-temp3(i,a)*Y[a][j];
+            }
+            dP_dF[i][j][k][l]=value;
+          }
+        }
+      }
+    }
+  }
+}
+
 template <int dim>
-void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
+bool crystalPlasticity<dim>::calculatePlasticitySubstep(unsigned int cellID,
   unsigned int quadPtID, unsigned int StiffnessCalFlag)
   {
 
@@ -21,18 +123,19 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
     Vector<double> W_kh_t(n_Tslip_systems); // Backstress
     Vector<double> rot1(dim);// Crystal orientation (Rodrigues representation)
 
-    // Tolerance
-    double tol1=this->userInputs.modelStressTolerance;
+    // Tolerance (loosened in the early nonlinear iterations with inexact local tolerances)
+    double tol1=this->userInputs.modelStressTolerance*this->localToleranceFactor;
     std::cout.precision(16);
 
-    FE_t=Fe_conv[cellID][quadPtID];
-    FP_t=Fp_conv[cellID][quadPtID];
+    //state at the start of the (sub)step, set in calculatePlasticity()
+    FE_t=FE_t_sub;
+    FP_t=FP_t_sub;
 
     for (unsigned int i = 0;i<n_Tslip_systems;i++) {
-      s_alpha_t[i]=s_alpha_conv[cellID][quadPtID][i];
-      W_kh_t[i] = W_kh_conv[cellID][quadPtID][i];
+      s_alpha_t[i]=s_alpha_t_sub[i];
+      W_kh_t[i] = W_kh_t_sub[i];
     }
-    rot1=rot_conv[cellID][quadPtID];
+    rot_conv.get(cellID,quadPtID,rot1);
 
 
 
@@ -46,8 +149,7 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
     FullMatrix<double> T_tau(dim,dim),P_tau(dim,dim);
     FullMatrix<double> Fpn_inv(dim,dim),FE_tau_trial(dim,dim),F_trial(dim,dim),CE_tau_trial(dim,dim),FP_t2(dim,dim),Ee_tau_trial(dim,dim);
 
-    FullMatrix<double> Dmat2(2*dim,2*dim),TM(dim*dim,dim*dim);
-    Vector<double> vec1(2*dim),vec2(dim*dim);
+    FullMatrix<double> Dmat2(2*dim,2*dim);
 
     elasticmoduli(Dmat2, rotmat, elasticStiffnessMatrix);
 
@@ -67,17 +169,90 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
       }
     }
 
-    vec1(0)=0;vec1(1)=5;vec1(2)=4;vec1(3)=1;vec1(4)=3;vec1(5)=2;
-    vec2(0)=0;vec2(1)=5;vec2(2)=4;vec2(3)=5;vec2(4)=1;vec2(5)=3;vec2(6)=4;vec2(7)=3;vec2(8)=2;
+    //% % % % % Elastic predictor % % % % %
+    // The trial stress is computed with the plastic deformation gradient of the start of the
+    // (sub)step. If no slip system reaches its resistance (the active set search below would find
+    // no potentially active system in its first pass), the step is elastic: the state is committed
+    // with the elastic tangent, without the Schmid tensors, the active set search and its workspace.
+    // The resolved shear stresses are evaluated in the crystal frame, m*(R^T*Ce*T_star*R)*n.
+    Fpn_inv=0.0; Fpn_inv.invert(FP_t);
+    FE_tau.reinit(dim,dim);
+    F_tau.mmult(FE_tau,Fpn_inv);
+    FE_tau.Tmmult(CE_tau_trial,FE_tau);
+    Ee_tau_trial=CE_tau_trial;
+    for(unsigned int i=0;i<dim;i++){
+      for(unsigned int j=0;j<dim;j++){
+        Ee_tau_trial[i][j] = 0.5*(Ee_tau_trial[i][j]-(i==j));
+      }
+    }
+    FullMatrix<double> T_star_tau_elastic(dim,dim);
+    Vector<double> stressVoigt(6);
+    Dmat.vmult(stressVoigt, vecform(Ee_tau_trial));
+    matform(T_star_tau_elastic,stressVoigt);
+
+    CE_tau_trial.mmult(temp,T_star_tau_elastic);
+    temp.mmult(temp1,rotmat);
+    rotmat.Tmmult(temp2,temp1);
+
+    bool elasticStep=true;
+    for(unsigned int i=0;(i<n_Tslip_systems)&&elasticStep;i++){
+      double resolvedShear=0.0;
+      for (unsigned int j=0;j<dim;j++){
+        for (unsigned int k=0;k<dim;k++){
+          resolvedShear+=m_alpha[i][j]*temp2[j][k]*n_alpha[i][k];
+        }
+      }
+      if ((i>n_slip_systems-1)&&(resolvedShear<W_kh_t(i))) resolvedShear=W_kh_t(i);
+      if ((fabs(resolvedShear-W_kh_t(i))-s_alpha_t(i))>=tol1) elasticStep=false;
+    }
+
+    if (elasticStep){
+      FP_tau=FP_t;
+      const double det_FE_elastic=FE_tau.determinant();
+      FE_tau.mmult(temp,T_star_tau_elastic);
+      temp.equ(1.0/det_FE_elastic,temp); temp.mTmult(T_tau,FE_tau);
+      temp.invert(F_tau); T_tau.mTmult(temp2,temp);
+      P_tau.equ(det_FE_elastic,temp2);
+
+      if (StiffnessCalFlag==1){
+        //delFe_delF of the elastic step: column kl is e_k*e_l^T*inv(Fp)
+        FullMatrix<double> delFe_delF(dim*dim,dim*dim);
+        for (unsigned int k=0;k<dim;k++){
+          for (unsigned int l=0;l<dim;l++){
+            for (unsigned int j=0;j<dim;j++){
+              delFe_delF(3*(k)+j,3*(k)+l)=Fpn_inv(l,j);
+            }
+          }
+        }
+        assembleTangentModulus<dim>(F_tau,FE_tau,T_star_tau_elastic,Dmat2,delFe_delF,dP_dF);
+      }
+
+      for (unsigned int i=0;i<n_twin_systems;i++){
+        twinfraction_iter.set(cellID,quadPtID,i,twinfraction_t_sub[i]);
+      }
+      for (unsigned int i=0;i<n_slip_systems;i++){
+        slipfraction_iter[cellID][quadPtID][i]=slipfraction_t_sub[i];
+      }
+
+      P.reinit(dim,dim);
+      P=P_tau;
+      T=T_tau;
+      sres_tau.reinit(n_Tslip_systems);
+      sres_tau = s_alpha_t;
+      Wkh_tau.reinit(n_Tslip_systems);
+      Wkh_tau = W_kh_t;
 
-    for(unsigned int i=0;i<9;i++){
-      for(unsigned int j=0;j<9;j++){
-        TM[i][j]=Dmat2(vec2(i),vec2(j));
+      if (slipIncrement_iter.size()>0){
+        slipIncrement_iter[cellID][quadPtID].reinit(n_Tslip_systems);
       }
+
+      commitSubstepHistory(cellID,quadPtID);
+
+      return std::isfinite(P_tau.frobenius_norm());
     }
 
-    // Calculation of Schmid Tensors  and B= symm(FE_tau_trial'*FE_tau_trial*S_alpha)
-    FullMatrix<double> SCHMID_TENSOR1(n_Tslip_systems*dim,dim),B(n_Tslip_systems*dim,dim);
+    // Calculation of Schmid Tensors
+    FullMatrix<double> SCHMID_TENSOR1(n_Tslip_systems*dim,dim);
     Vector<double> m1(dim),n1(dim);
 
     for (unsigned int i = 0;i<n_Tslip_systems;i++) {
@@ -102,13 +277,6 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
           SCHMID_TENSOR1[dim*i + j][k] = temp[j][k];
         }
       }
-      CE_tau_trial.mmult(temp2, temp);
-      temp2.symmetrize();
-      for (unsigned int j = 0;j<dim;j++) {
-        for (unsigned int k = 0;k<dim;k++) {
-          B[dim*i + j][k] = 2 * temp2[j][k];
-        }
-      }
     }
 
 
@@ -116,20 +284,21 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
     Vector<double> s_alpha_tau;
     Vector<double> W_kh_tau;
     Vector<double> s_beta(n_Tslip_systems),h_beta(n_Tslip_systems),delh_beta_dels(n_Tslip_systems);
-    FullMatrix<double> h_alpha_beta_t(n_Tslip_systems,n_Tslip_systems),A(n_Tslip_systems,n_Tslip_systems);
+    FullMatrix<double> A(n_Tslip_systems,n_Tslip_systems);
+    Vector<double> hardeningRate(n_Tslip_systems),hardeningIncrement(n_Tslip_systems);
     FullMatrix<double> del_FP(dim,dim);
     FullMatrix<double> A_PA;
     Vector<double> active;
     Vector<double> PA, PA_temp(1);
     Vector<double> resolved_shear_tau_trial(n_Tslip_systems),b(n_Tslip_systems),resolved_shear_tau(n_Tslip_systems);
-    Vector<double> x_beta_old(n_Tslip_systems);
+    Vector<double> x_beta_old(n_Tslip_systems), slipIncrement(n_Tslip_systems);
 
     Vector<double> x_beta(n_Tslip_systems);
 
     FullMatrix<double> PK1_Stiff(dim*dim,dim*dim);
 
     FullMatrix<double> delFp_delF(dim*dim,dim*dim),delFp_delF2(dim*dim,dim*dim),delFp_delF_prev(dim*dim,dim*dim),dels_delF(n_Tslip_systems,dim*dim),dels_delF_prev(n_Tslip_systems,dim*dim),A2;
-    FullMatrix<double> delFe_delF(dim*dim,dim*dim),delEtrial_delF(dim*dim,dim*dim),deltau_delF(dim*dim,dim*dim),delT_delF(dim*dim,dim*dim),delb_delF,delgamma_delF,S_PA,A_ds(n_Tslip_systems,n_Tslip_systems),delgamma_delF2(n_Tslip_systems,dim*dim),delTstar_delF(dim*dim,dim*dim);
+    FullMatrix<double> delFe_delF(dim*dim,dim*dim),delEtrial_delF(dim*dim,dim*dim),deltau_delF(dim*dim,dim*dim),delT_delF(dim*dim,dim*dim),delb_delF,delgamma_delF,S_PA,delgamma_delF2(n_Tslip_systems,dim*dim);
     FullMatrix<double> Ce_tau(dim,dim),T_star_tau(dim,dim);
     FullMatrix<double> T_star_tau_trial(dim,dim),diff_FP(dim,dim);
 
@@ -264,40 +433,51 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
 
       for(unsigned int i=0;i<n_Tslip_systems;i++){
         for(unsigned int j=0;j<n_Tslip_systems;j++){
-          h_alpha_beta_t[i][j] = q[i][j]*h_beta(j);
-          A[i][j]=h_alpha_beta_t[i][j];
+          A[i][j]=q[i][j]*h_beta(j);
         }
       }
 
       // Calculate the Stiffness Matrix A
-      for(unsigned int i=0;i<n_Tslip_systems;i++){
-        for(unsigned int j=0;j<n_Tslip_systems;j++){
-          temp1.reinit(dim,dim); temp1=0.0;
-
-          for(unsigned int k=0;k<dim;k++){
-            for(unsigned int l=0;l<dim;l++){
-              temp[k][l]=SCHMID_TENSOR1(dim*j+k,l);
-            }
+      // The stress response Ce*(Dmat:sym(Ce*S_j))+2*sym(Ce*S_j)*T_star of each system j is computed
+      // once, and projected on the Schmid tensors of all systems i
+      FullMatrix<double> SCHMID_RESPONSE(n_Tslip_systems*dim,dim);
+      for(unsigned int j=0;j<n_Tslip_systems;j++){
+        temp1.reinit(dim,dim); temp1=0.0;
+
+        for(unsigned int k=0;k<dim;k++){
+          for(unsigned int l=0;l<dim;l++){
+            temp[k][l]=SCHMID_TENSOR1(dim*j+k,l);
           }
-          temp2.reinit(dim,dim); CE_tau_trial.mmult(temp2,temp);
-          temp2.symmetrize();
-          tempv1=0.0; Dmat.vmult(tempv1, vecform(temp2));
-          temp3=0.0; matform(temp3,tempv1);
+        }
+        temp2.reinit(dim,dim); CE_tau_trial.mmult(temp2,temp);
+        temp2.symmetrize();
+        tempv1=0.0; Dmat.vmult(tempv1, vecform(temp2));
+        temp3=0.0; matform(temp3,tempv1);
 
-          CE_tau_trial.mmult(temp1,temp3);
-          temp3=0.0; temp2.mmult(temp3,T_star_tau_trial);
+        CE_tau_trial.mmult(temp1,temp3);
+        temp3=0.0; temp2.mmult(temp3,T_star_tau_trial);
 
-          temp1.add(2.0,temp3);
+        temp1.add(2.0,temp3);
 
+        for(unsigned int k=0;k<dim;k++){
+          for(unsigned int l=0;l<dim;l++){
+            SCHMID_RESPONSE(dim*j+k,l)=temp1[k][l];
+          }
+        }
+      }
+
+      for(unsigned int i=0;i<n_Tslip_systems;i++){
+        for(unsigned int j=0;j<n_Tslip_systems;j++){
+          double projection=0.0;
           for(unsigned int k=0;k<dim;k++){
             for(unsigned int l=0;l<dim;l++){
-              if(((resolved_shear_tau_trial(i)-W_kh_tau(i))*(resolved_shear_tau_trial(j) - W_kh_tau(j)))<0.0)
-              A[i][j]-=SCHMID_TENSOR1(dim*i+k,l)*temp1[k][l];
-              else
-              A[i][j]+=SCHMID_TENSOR1(dim*i+k,l)*temp1[k][l];
-
+              projection+=SCHMID_TENSOR1(dim*i+k,l)*SCHMID_RESPONSE(dim*j+k,l);
             }
           }
+          if(((resolved_shear_tau_trial(i)-W_kh_tau(i))*(resolved_shear_tau_trial(j) - W_kh_tau(j)))<0.0)
+          A[i][j]-=projection;
+          else
+          A[i][j]+=projection;
           if ((resolved_shear_tau_trial(i) - W_kh_tau(i))<0.0)
           A[i][j] -= C_1[i]-C_2[i]*W_kh_tau(i);
           else
@@ -308,6 +488,28 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
 
 
 
+      // Warm start: in the first pass, the active set is restricted to the systems which were active
+      // in the last solve at this point, and their slip increments (scaled to the substep) are taken
+      // as the first iterate. Systems left out are picked up by the next pass of the search.
+      bool warmStart=false;
+      if ((iter1==1)&&this->userInputs.enableSlipWarmStart&&(slipIncrement_iter.size()>0)&&(slipIncrement_iter[cellID][quadPtID].size()==n_Tslip_systems)){
+        const Vector<double> &lastIncrement=slipIncrement_iter[cellID][quadPtID];
+        unsigned int n_warm=0;
+        for(unsigned int i=0;i<n_PA;i++){
+          if (lastIncrement(PA(i))>0.0) n_warm++;
+        }
+        if (n_warm>0){
+          PA_temp=PA;
+          PA.reinit(n_warm);
+          n_warm=0;
+          for(unsigned int i=0;i<n_PA;i++){
+            if (lastIncrement(PA_temp(i))>0.0) PA(n_warm++)=PA_temp(i);
+          }
+          n_PA=n_warm;
+          warmStart=true;
+        }
+      }
+
       x_beta_old=0.0;
 
       unsigned int count1=0;
@@ -329,11 +531,18 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
 
         x_beta=0.0;
 
-
-
-        //Modified slip system search for adding corrective term
-        // [x_beta] = INACTIVE_SLIP_REMOVAL(A,b,PA,x_beta_old);
-        inactive_slip_removal(active,x_beta_old,x_beta,n_PA,n_Tslip_systems,PA,b,A,A_PA);
+        if (warmStart){
+          for(unsigned int i=0;i<n_PA;i++){
+            x_beta(PA(i))=substepFraction*slipIncrement_iter[cellID][quadPtID](PA(i));
+          }
+          x_beta_old=x_beta;
+          warmStart=false;
+        }
+        else{
+          //Modified slip system search for adding corrective term
+          // [x_beta] = INACTIVE_SLIP_REMOVAL(A,b,PA,x_beta_old);
+          inactive_slip_removal(active,x_beta_old,x_beta,n_PA,n_Tslip_systems,PA,b,A,A_PA);
+        }
         temp.reinit(dim,dim);
         del_FP.reinit(dim,dim);
         del_FP=0.0;
@@ -398,15 +607,11 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
 
         // % % % % % STEP 9 % % % % %
 
-        double h1=0;
-        for(unsigned int i=0;i<n_Tslip_systems;i++){
-          h1=0;
-          for(unsigned int j=0;j<n_Tslip_systems;j++){
-            h1=h1+h_alpha_beta_t(i,j)*x_beta(j);
-          }
-          s_alpha_tau(i)=s_alpha_tau(i)+h1;
-
+        for(unsigned int j=0;j<n_Tslip_systems;j++){
+          hardeningRate(j)=h_beta(j)*x_beta(j);
         }
+        latentHardeningVmult(hardeningIncrement,hardeningRate);
+        s_alpha_tau.add(1.0,hardeningIncrement);
 
         for (unsigned int i = 0;i<n_slip_systems;i++) {//
 
@@ -447,12 +652,14 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
 
       }
 
+      slipIncrement.add(1.0,x_beta_old);
+
       for (unsigned int i=0;i<n_twin_systems;i++){
-        twinfraction_iter[cellID][quadPtID][i]=twinfraction_conv[cellID][quadPtID][i]+x_beta_old[i+n_slip_systems]/twinShear;
+        twinfraction_iter.set(cellID,quadPtID,i,twinfraction_t_sub[i]+x_beta_old[i+n_slip_systems]/twinShear);
       }
 
       for (unsigned int i=0;i<n_slip_systems;i++){
-        slipfraction_iter[cellID][quadPtID][i]=slipfraction_conv[cellID][quadPtID][i]+x_beta_old[i];
+        slipfraction_iter[cellID][quadPtID][i]=slipfraction_t_sub[i]+x_beta_old[i];
       }
 
       Fpn_inv = 0.0; Fpn_inv.invert(FP_tau);
@@ -477,58 +684,34 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
         dels_delF_prev=dels_delF;
 
 
-        delFe_delF=0.0;
         temp1.reinit(dim,dim);
         F_tau.mmult(temp1,Fpn_inv);
-
-        for (unsigned int i=0;i<dim;i++){
-          for (unsigned int j=0;j<dim;j++){
-            for (unsigned int k=0;k<dim;k++){
-              for (unsigned int l=0;l<dim;l++){
-                for (unsigned int a=0;a<dim;a++){
-                  for (unsigned int b=0;b<dim;b++){
-                    delFe_delF(3*i+j,3*k+l)=delFe_delF(3*i+j,3*k+l)-temp1(i,a)*delFp_delF(3*a+b,3*k+l)*Fpn_inv(b,j);
-                  }
-                }
-                if(i==k){
-                  delFe_delF(3*i+j,3*k+l)=delFe_delF(3*i+j,3*k+l)+Fpn_inv(l,j);
-                }
+        elasticDeformationGradientDerivative(temp1,Fpn_inv,delFp_delF,delFe_delF);
+
+        // delEtrial_delF and delT_delF are symmetric in (i,j): the 6 independent rows are computed,
+        // and delT_delF uses the 6x6 elastic moduli
+        double E[6], dT[3][3];
+        for (unsigned int k=0;k<dim;k++){
+          for (unsigned int l=0;l<dim;l++){
+            for (unsigned int v=0;v<6;v++){
+              const unsigned int i=voigtPair[v][0], j=voigtPair[v][1];
+              E[v]=0.0;
+              for (unsigned int a=0;a<dim;a++){
+                E[v]=E[v]+0.5*(delFe_delF(3*(a)+i,3*(k)+l)*FE_tau(a,j)+delFe_delF(3*(a)+j,3*(k)+l)*FE_tau(a,i));
               }
+              delEtrial_delF(3*(i)+j,3*(k)+l)=E[v];
+              delEtrial_delF(3*(j)+i,3*(k)+l)=E[v];
             }
-          }
-        }
-
-        delEtrial_delF=0.0;
-        for (unsigned int i=0;i<dim;i++){
-          for (unsigned int j=0;j<dim;j++){
-            for (unsigned int k=0;k<dim;k++){
-              for (unsigned int l=0;l<dim;l++){
-                for (unsigned int a=0;a<dim;a++){
-
-
-                  delEtrial_delF(3*(i)+j,3*(k)+l)=delEtrial_delF(3*(i)+j,3*(k)+l)+0.5*(delFe_delF(3*(a)+i,3*(k)+l)*FE_tau(a,j)+delFe_delF(3*(a)+j,3*(k)+l)*FE_tau(a,i));
-                }
+            voigtStress(Dmat2,E,dT);
+            for (unsigned int i=0;i<dim;i++){
+              for (unsigned int j=0;j<dim;j++){
+                delT_delF(3*(i)+j,3*(k)+l)=dT[i][j];
               }
             }
           }
         }
 
-
-
         deltau_delF=0.0;
-        temp.reinit(dim,dim);
-        temp=0.0;
-        temp.Tadd(-1.0,del_FP);
-        temp1.reinit(dim,dim);
-        temp1=matrixExponential(temp);
-
-
-        temp1.reinit(dim,dim);
-        temp=0.0;
-        temp.add(-1.0,del_FP);
-        temp2.reinit(dim,dim);
-        temp2=matrixExponential(temp);
-        TM.mmult(delT_delF,delEtrial_delF);
 
         for (unsigned int i=0;i<dim;i++){
           for (unsigned int j=0;j<dim;j++){
@@ -620,11 +803,10 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
 
 
         A2.reinit(n_PA,n_PA);
-        A_ds=h_alpha_beta_t;
 
         for(unsigned int i=0;i<n_PA;i++){
           for(unsigned int j=0;j<n_PA;j++){
-            A2(i,j)=h_alpha_beta_t(PA(i),PA(j));
+            A2(i,j)=q(PA(i),PA(j))*h_beta(PA(j));
           }
         }
 
@@ -820,8 +1002,17 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
 
         delFp_delF.add(1.0,delFp_delF2);
 
+        //hardening of the slip resistances, (q_ij*h_j)*delgamma_delF2(j,:), in block form
         temp1.reinit(n_Tslip_systems,dim*dim);
-        A_ds.mmult(temp1,delgamma_delF2);
+        for(unsigned int l=0;l<dim*dim;l++){
+          for(unsigned int j=0;j<n_Tslip_systems;j++){
+            hardeningRate(j)=h_beta(j)*delgamma_delF2(j,l);
+          }
+          latentHardeningVmult(hardeningIncrement,hardeningRate);
+          for(unsigned int i=0;i<n_Tslip_systems;i++){
+            temp1(i,l)=hardeningIncrement(i);
+          }
+        }
 
         dels_delF_prev=dels_delF;
         dels_delF_prev.add(1.0,temp1);
@@ -833,129 +1024,117 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
 
 
     if (StiffnessCalFlag==1){
-      delFe_delF=0.0;
       temp1.reinit(dim,dim);
       F_tau.mmult(temp1,Fpn_inv);
+      elasticDeformationGradientDerivative(temp1,Fpn_inv,delFp_delF,delFe_delF);
+      assembleTangentModulus<dim>(F_tau,FE_tau,T_star_tau,Dmat2,delFe_delF,dP_dF);
+    }
 
-      for (unsigned int i=0;i<dim;i++){
-        for (unsigned int j=0;j<dim;j++){
-          for (unsigned int k=0;k<dim;k++){
-            for (unsigned int l=0;l<dim;l++){
-              for (unsigned int a=0;a<dim;a++){
-                for (unsigned int b=0;b<dim;b++){
-                  delFe_delF(3*i+j,3*k+l)=delFe_delF(3*i+j,3*k+l)-temp1(i,a)*delFp_delF(3*a+b,3*k+l)*Fpn_inv(b,j);
-                }
-              }
-              if(i==k){
-                delFe_delF(3*i+j,3*k+l)=delFe_delF(3*i+j,3*k+l)+Fpn_inv(l,j);
-              }
-            }
-          }
-        }
-      }
-
-      delTstar_delF=0.0;
-
-
-
-      for (unsigned int i=0;i<dim;i++){
-        for (unsigned int j=0;j<dim;j++){
-          for (unsigned int k=0;k<dim;k++){
-            for (unsigned int l=0;l<dim;l++){
-              for (unsigned int a=0;a<dim;a++){
-                for (unsigned int b=0;b<dim;b++){
-                  for (unsigned int c=0;c<dim;c++){
-
+    if ((slipIncrement_iter.size()>0)&&(flag2==0)){
+      slipIncrement_iter[cellID][quadPtID].reinit(n_Tslip_systems);
+      slipIncrement_iter[cellID][quadPtID].add(1.0/substepFraction,slipIncrement);
+    }
 
-                    delTstar_delF(3*(i)+j,3*(k)+l)=delTstar_delF(3*(i)+j,3*(k)+l)+ TM(3*(i)+j,3*(a)+b)*delFe_delF(3*(c)+a,3*(k)+l)*FE_tau(c,b);
+    P.reinit(dim,dim);
+    P=P_tau;
+    T=T_tau;
 
-                  }
-                }
-              }
 
-            }
-          }
-        }
-      }
+    sres_tau.reinit(n_Tslip_systems);
+    sres_tau = s_alpha_tau;
+    Wkh_tau.reinit(n_Tslip_systems);
+    Wkh_tau = W_kh_tau;
 
+    commitSubstepHistory(cellID,quadPtID);
 
+    //the (sub)step failed if the active slip search did not converge or the stress is not finite
+    return ((flag2==0)&&(std::isfinite(P_tau.frobenius_norm())));
+  }
 
-      FullMatrix<double> PK_Stiff5(dim*dim,dim*dim);
-      PK_Stiff5=0.0;
-      temp4.reinit(dim,dim);
-      temp4.invert(F_tau);
-      temp.reinit(dim,dim);
-      temp4.mmult(temp,FE_tau);
-      temp1.reinit(dim,dim);
-      T_star_tau.mTmult(temp1,temp);
-      temp2.reinit(dim,dim);
-      temp4.mmult(temp2,FE_tau); // Transpose the matrix
-      temp3.reinit(dim,dim);
-      FE_tau.mmult(temp3,T_star_tau);
-      temp5.reinit(dim,dim);
-      temp3.mTmult(temp5,F_tau);
-      temp6=IdentityMatrix(dim);
-
-      for (unsigned int i=0;i<dim;i++){
-        for (unsigned int j=0;j<dim;j++){
-          for (unsigned int k=0;k<dim;k++){
-            for (unsigned int l=0;l<dim;l++){
-              for (unsigned int a=0;a<dim;a++){
-                for (unsigned int b=0;b<dim;b++){
-                  PK_Stiff5(3*(i)+j,3*(k)+l)=PK_Stiff5(3*(i)+j,3*(k)+l)+ temp6(i,a)*delFe_delF(3*(a)+b,3*(k)+l)*temp1(b,j)+FE_tau(i,a)*delTstar_delF(3*(a)+b,3*(k)+l)*temp2(j,b)-temp3(i,a)*delFe_delF(3*(a)+b,3*(k)+l)*temp4(j,b);
-                }
-                PK_Stiff5(3*(i)+j,3*(k)+l)=PK_Stiff5(3*(i)+j,3*(k)+l)-temp5(i,a)*temp4(j,k)*temp4(l,a);
-              }
+//Integrates the constitutive model over the current increment. If the material point
+//solve fails, the increment of the deformation gradient (from F_t=Fe_t*Fp_t to F) is split
+//into 2,4,... equal substeps (at most modelMaxSubsteps), which are integrated sequentially.
+//The tangent modulus is computed in the last substep only, with its start state held fixed.
+//If all subdivisions fail, the increment is reset.
+//The warm start slip increments of the material point are stored normalized to the full increment.
+template <int dim>
+void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
+  unsigned int quadPtID, unsigned int StiffnessCalFlag)
+  {
+    FE_t_sub=Fe_conv[cellID][quadPtID];
+    FP_t_sub=Fp_conv[cellID][quadPtID];
+    s_alpha_conv.get(cellID,quadPtID,s_alpha_t_sub);
+    W_kh_conv.get(cellID,quadPtID,W_kh_t_sub);
+    slipfraction_t_sub=slipfraction_conv[cellID][quadPtID];
+    twinfraction_conv.get(cellID,quadPtID,twinfraction_t_sub);
+    substepFraction=1.0;
+
+    if ((calculatePlasticitySubstep(cellID, quadPtID, StiffnessCalFlag))||(this->userInputs.modelMaxSubsteps<2)){
+      return;
+    }
 
-            }
-          }
+    FullMatrix<double> F_end(F), F_start(dim,dim);
+    FE_t_sub.mmult(F_start,FP_t_sub);
+
+    unsigned int nSubsteps=2;
+    bool converged=false;
+    while (!converged){
+      //every attempt starts from the converged state of the last increment
+      FE_t_sub=Fe_conv[cellID][quadPtID];
+      FP_t_sub=Fp_conv[cellID][quadPtID];
+      s_alpha_conv.get(cellID,quadPtID,s_alpha_t_sub);
+      W_kh_conv.get(cellID,quadPtID,W_kh_t_sub);
+      slipfraction_t_sub=slipfraction_conv[cellID][quadPtID];
+      twinfraction_conv.get(cellID,quadPtID,twinfraction_t_sub);
+
+      substepFraction=1.0/nSubsteps;
+      for (unsigned int subStep=1; subStep<=nSubsteps; subStep++){
+        F.equ(1.0-double(subStep)/nSubsteps, F_start, double(subStep)/nSubsteps, F_end);
+        converged=calculatePlasticitySubstep(cellID, quadPtID, (subStep==nSubsteps)?StiffnessCalFlag:0);
+        if (!converged){
+          break;
         }
+        //the end state of this substep is the start state of the next one
+        FE_t_sub=FE_tau;
+        FP_t_sub=FP_tau;
+        s_alpha_iter.get(cellID,quadPtID,s_alpha_t_sub);
+        W_kh_iter.get(cellID,quadPtID,W_kh_t_sub);
+        slipfraction_t_sub=slipfraction_iter[cellID][quadPtID];
+        twinfraction_iter.get(cellID,quadPtID,twinfraction_t_sub);
       }
 
-
-      dP_dF=0.0;
-      FullMatrix<double> L(dim,dim),mn(dim,dim);
-      L = IdentityMatrix(dim);
-
-      // Transform the tangent modulus back to crystal frame
-
-
-      for(unsigned int m=0;m<dim;m++){
-        for(unsigned int n=0;n<dim;n++){
-          for(unsigned int o=0;o<dim;o++){
-            for(unsigned int p=0;p<dim;p++){
-              for(unsigned int i=0;i<dim;i++){
-                for(unsigned int j=0;j<dim;j++){
-                  for(unsigned int k=0;k<dim;k++){
-                    for(unsigned int l=0;l<dim;l++){
-                      dP_dF[m][n][o][p]=dP_dF[m][n][o][p]+PK_Stiff5(dim*i+j,dim*k+l)*L(i,m)*L(j,n)*L(k,o)*L(l,p);
-                    }
-                  }
-                }
-              }
-            }
-          }
-        }
+      if (2*nSubsteps>this->userInputs.modelMaxSubsteps){
+        break;
       }
+      nSubsteps*=2;
     }
+    F=F_end;
+
+    //if all subdivisions failed, the increment is reset (and cut back once per processor, the
+    //processors agree on the smallest load factor in assemble()). The reset is reported once by
+    //testConvergenceAfterIteration() after the processors have synced resetIncrement.
+    if ((!converged)&&(!this->resetIncrement)){
+      double cutbackFactor=this->userInputs.adaptiveLoadStepFactor;
+      if ((cutbackFactor<=0.0)||(cutbackFactor>=1.0)) cutbackFactor=0.5;
+      this->resetIncrement=true;
+      this->loadFactorSetByModel*=cutbackFactor;
+    }
+  }
 
-    P.reinit(dim,dim);
-    P=P_tau;
-    T=T_tau;
-
-
-    sres_tau.reinit(n_Tslip_systems);
-    sres_tau = s_alpha_tau;
-    Wkh_tau.reinit(n_Tslip_systems);
-    Wkh_tau = W_kh_tau;
+//Stores the end state of a (sub)step in the iteration history, and reorients the material
+//point if the twin volume fraction exceeds the threshold fraction
+template <int dim>
+void crystalPlasticity<dim>::commitSubstepHistory(unsigned int cellID, unsigned int quadPtID)
+{
+    FullMatrix<double> rotmat(dim,dim);
 
     // Update the history variables
     Fe_iter[cellID][quadPtID]=FE_tau;
     Fp_iter[cellID][quadPtID]=FP_tau;
 
     for (unsigned int i = 0;i<n_Tslip_systems;i++) {
-      s_alpha_iter[cellID][quadPtID][i]=sres_tau[i];
-      W_kh_iter[cellID][quadPtID][i] = Wkh_tau[i];
+      s_alpha_iter.set(cellID,quadPtID,i,sres_tau[i]);
+      W_kh_iter.set(cellID,quadPtID,i,Wkh_tau[i]);
     }
 
 
@@ -984,7 +1163,7 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
         F_T = 1.0;
       }
       local_twin.resize(n_twin_systems,0.0);
-      local_twin=twinfraction_iter[cellID][quadPtID];
+      twinfraction_iter.get(cellID,quadPtID,local_twin);
       result = std::max_element(local_twin.begin(), local_twin.end());
       twin_pos= std::distance(local_twin.begin(), result);
       twin_max=local_twin[twin_pos];
@@ -992,7 +1171,7 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
         if(F_r>0){
           if(twin_max > F_T){
 
-            rod(0) = rot_conv[cellID][quadPtID][0];rod(1) = rot_conv[cellID][quadPtID][1];rod(2) = rot_conv[cellID][quadPtID][2];
+            rod(0) = rot_conv(cellID,quadPtID,0);rod(1) = rot_conv(cellID,quadPtID,1);rod(2) = rot_conv(cellID,quadPtID,2);
             odfpoint(rotmat, rod);
             rod2quat(quat2, rod);
             quat1(0) = 0;
@@ -1007,18 +1186,16 @@ void crystalPlasticity<dim>::calculatePlasticity(unsigned int cellID,
 
             odfpoint(rotmat, rod);
 
-            rot_iter[cellID][quadPtID][0] = rod(0);rot_iter[cellID][quadPtID][1] = rod(1);rot_iter[cellID][quadPtID][2] = rod(2);
-            rotnew_iter[cellID][quadPtID][0] = rod(0);rotnew_iter[cellID][quadPtID][1] = rod(1);rotnew_iter[cellID][quadPtID][2] = rod(2);
+            rot_iter.set(cellID,quadPtID,0,rod(0));rot_iter.set(cellID,quadPtID,1,rod(1));rot_iter.set(cellID,quadPtID,2,rod(2));
+            rotnew_iter.set(cellID,quadPtID,0,rod(0));rotnew_iter.set(cellID,quadPtID,1,rod(1));rotnew_iter.set(cellID,quadPtID,2,rod(2));
             twin_iter[cellID][quadPtID] = 1.0;
             for (unsigned int i = 0;i < n_twin_systems;i++) {
-              s_alpha_iter[cellID][quadPtID][n_slip_systems + i] =100000;
+              s_alpha_iter.set(cellID,quadPtID,n_slip_systems + i,100000);
             }
           }
         }
       }
     }
-
-
-  }
+}
 
   #include "../../../include/crystalPlasticity_template_instantiations.h"
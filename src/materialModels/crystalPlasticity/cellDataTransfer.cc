@@ -0,0 +1,240 @@
+#include "../../../include/crystalPlasticity.h"
+
+//Each history field is written as the number of quadrature points followed by the values of every
+//quadrature point (with their sizes), so fields which are not allocated for the current model are
+//written as empty and skipped on unpacking. Children of a refined cell take the values of the
+//nearest quadrature point of the parent, and a coarsened cell those of the nearest quadrature point
+//of its children.
+
+namespace {
+  void packValue(double value, std::vector<double>& data){
+    data.push_back(value);
+  }
+
+  void packValue(unsigned int value, std::vector<double>& data){
+    data.push_back(value);
+  }
+
+  void packValue(const Vector<double>& value, std::vector<double>& data){
+    data.push_back(value.size());
+    for (unsigned int i=0; i<value.size(); i++) data.push_back(value(i));
+  }
+
+  void packValue(const FullMatrix<double>& value, std::vector<double>& data){
+    data.push_back(value.m()); data.push_back(value.n());
+    for (unsigned int i=0; i<value.m(); i++)
+    for (unsigned int j=0; j<value.n(); j++) data.push_back(value(i,j));
+  }
+
+  template <typename T>
+  void packValue(const std::vector<T>& value, std::vector<double>& data){
+    data.push_back(value.size());
+    for (unsigned int i=0; i<value.size(); i++) data.push_back(value[i]);
+  }
+
+  void unpackValue(double& value, const std::vector<double>& data, unsigned int& pos){
+    value=data[pos++];
+  }
+
+  void unpackValue(unsigned int& value, const std::vector<double>& data, unsigned int& pos){
+    value=(unsigned int)data[pos++];
+  }
+
+  void unpackValue(Vector<double>& value, const std::vector<double>& data, unsigned int& pos){
+    value.reinit((unsigned int)data[pos++]);
+    for (unsigned int i=0; i<value.size(); i++) value(i)=data[pos++];
+  }
+
+  void unpackValue(FullMatrix<double>& value, const std::vector<double>& data, unsigned int& pos){
+    const unsigned int m=(unsigned int)data[pos++], n=(unsigned int)data[pos++];
+    value.reinit(m,n);
+    for (unsigned int i=0; i<m; i++)
+    for (unsigned int j=0; j<n; j++) value(i,j)=data[pos++];
+  }
+
+  template <typename T>
+  void unpackValue(std::vector<T>& value, const std::vector<double>& data, unsigned int& pos){
+    value.resize((unsigned int)data[pos++]);
+    for (unsigned int i=0; i<value.size(); i++) value[i]=(T)data[pos++];
+  }
+
+  //per quadrature point field, packed from the (cellID, quadPtID) sources of the quadrature points
+  template <typename T>
+  void packField(const std::vector<std::vector<T> >& field, const std::vector<std::pair<unsigned int,unsigned int> >& sources, std::vector<double>& data){
+    if (field.size()==0){
+      data.push_back(0);
+      return;
+    }
+    data.push_back(sources.size());
+    for (unsigned int q=0; q<sources.size(); q++) packValue(field[sources[q].first][sources[q].second], data);
+  }
+
+  template <typename T>
+  void unpackField(std::vector<std::vector<T> >& field, unsigned int cellID, const std::vector<unsigned int>& quadPtMap, const std::vector<double>& data, unsigned int& pos){
+    const unsigned int num_quad_points=(unsigned int)data[pos++];
+    if (num_quad_points==0) return;
+    std::vector<T> values(num_quad_points);
+    for (unsigned int q=0; q<num_quad_points; q++) unpackValue(values[q], data, pos);
+    field[cellID].resize(quadPtMap.size());
+    for (unsigned int q=0; q<quadPtMap.size(); q++) field[cellID][q]=values[quadPtMap[q]];
+  }
+
+  //only fields which are allocated for the current model are resized
+  template <typename T>
+  void resizeField(std::vector<std::vector<T> >& field, unsigned int numLocalCells){
+    if (field.size()>0) field.resize(numLocalCells);
+  }
+
+  //quadratureHistory fields are packed in the same format, the values are packed in double precision
+  void packField(const quadratureHistory& field, const std::vector<std::pair<unsigned int,unsigned int> >& sources, std::vector<double>& data){
+    if (field.n_components()==0){
+      data.push_back(0);
+      return;
+    }
+    data.push_back(sources.size());
+    for (unsigned int q=0; q<sources.size(); q++){
+      data.push_back(field.n_components());
+      for (unsigned int i=0; i<field.n_components(); i++) data.push_back(field(sources[q].first, sources[q].second, i));
+    }
+  }
+
+  void unpackField(quadratureHistory& field, unsigned int cellID, const std::vector<unsigned int>& quadPtMap, const std::vector<double>& data, unsigned int& pos){
+    const unsigned int num_quad_points=(unsigned int)data[pos++];
+    if (num_quad_points==0) return;
+    std::vector<Vector<double> > values(num_quad_points);
+    for (unsigned int q=0; q<num_quad_points; q++) unpackValue(values[q], data, pos);
+    for (unsigned int q=0; q<quadPtMap.size(); q++) field.set(cellID, q, values[quadPtMap[q]]);
+  }
+
+  void resizeField(quadratureHistory& field, unsigned int numLocalCells){
+    if (field.n_components()>0) field.resize(numLocalCells);
+  }
+}
+
+template <int dim>
+void crystalPlasticity<dim>::packCellData(const std::vector<std::pair<unsigned int,unsigned int> >& sources, std::vector<double>& data)
+{
+  data.push_back(cellOrientationMap[sources[0].first]);
+
+  packField(Fe_conv, sources, data);
+  packField(Fp_conv, sources, data);
+  packField(s_alpha_conv, sources, data);
+  packField(W_kh_conv, sources, data);
+  packField(rot_conv, sources, data);
+  packField(rotnew_conv, sources, data);
+  packField(rot, sources, data);
+  packField(twinfraction_conv, sources, data);
+  packField(slipfraction_conv, sources, data);
+  packField(twin_conv, sources, data);
+  packField(twin_ouput, sources, data);
+  packField(phase, sources, data);
+  packField(CauchyStress, sources, data);
+  packField(TinterStress, sources, data);
+  packField(TinterStress_diff, sources, data);
+  packField(stateVar_conv, sources, data);
+  packField(VoxelData, sources, data);
+  packField(TwinMaxFlag_conv, sources, data);
+  packField(NumberOfTwinnedRegion_conv, sources, data);
+  packField(ActiveTwinSystems_conv, sources, data);
+  packField(TwinFlag_conv, sources, data);
+  packField(TwinOutputfraction_conv, sources, data);
+  packField(TotaltwinvfK, sources, data);
+  packField(slipIncrement_iter, sources, data);
+}
+
+template <int dim>
+void crystalPlasticity<dim>::resizeCellData(unsigned int numLocalCells)
+{
+  cellOrientationMap.resize(numLocalCells);
+
+  resizeField(Fe_conv, numLocalCells); resizeField(Fe_iter, numLocalCells);
+  resizeField(Fp_conv, numLocalCells); resizeField(Fp_iter, numLocalCells);
+  resizeField(s_alpha_conv, numLocalCells); resizeField(s_alpha_iter, numLocalCells);
+  resizeField(W_kh_conv, numLocalCells); resizeField(W_kh_iter, numLocalCells);
+  resizeField(rot_conv, numLocalCells); resizeField(rot_iter, numLocalCells);
+  resizeField(rotnew_conv, numLocalCells); resizeField(rotnew_iter, numLocalCells);
+  resizeField(rot, numLocalCells);
+  resizeField(twinfraction_conv, numLocalCells); resizeField(twinfraction_iter, numLocalCells);
+  resizeField(slipfraction_conv, numLocalCells); resizeField(slipfraction_iter, numLocalCells);
+  resizeField(twin_conv, numLocalCells); resizeField(twin_iter, numLocalCells);
+  resizeField(twin_ouput, numLocalCells);
+  resizeField(phase, numLocalCells);
+  resizeField(CauchyStress, numLocalCells);
+  resizeField(TinterStress, numLocalCells);
+  resizeField(TinterStress_diff, numLocalCells);
+  resizeField(stateVar_conv, numLocalCells); resizeField(stateVar_iter, numLocalCells);
+  resizeField(VoxelData, numLocalCells);
+  resizeField(TwinMaxFlag_conv, numLocalCells); resizeField(TwinMaxFlag_iter, numLocalCells);
+  resizeField(NumberOfTwinnedRegion_conv, numLocalCells); resizeField(NumberOfTwinnedRegion_iter, numLocalCells);
+  resizeField(ActiveTwinSystems_conv, numLocalCells); resizeField(ActiveTwinSystems_iter, numLocalCells);
+  resizeField(TwinFlag_conv, numLocalCells); resizeField(TwinFlag_iter, numLocalCells);
+  resizeField(TwinOutputfraction_conv, numLocalCells); resizeField(TwinOutputfraction_iter, numLocalCells);
+  resizeField(TotaltwinvfK, numLocalCells);
+  resizeField(slipIncrement_iter, numLocalCells);
+}
+
+template <int dim>
+void crystalPlasticity<dim>::unpackCellData(unsigned int cellID, const std::vector<unsigned int>& quadPtMap, const std::vector<double>& data)
+{
+  unsigned int pos=0;
+  cellOrientationMap[cellID]=(unsigned int)data[pos++];
+
+  unpackField(Fe_conv, cellID, quadPtMap, data, pos);
+  unpackField(Fp_conv, cellID, quadPtMap, data, pos);
+  unpackField(s_alpha_conv, cellID, quadPtMap, data, pos);
+  unpackField(W_kh_conv, cellID, quadPtMap, data, pos);
+  unpackField(rot_conv, cellID, quadPtMap, data, pos);
+  unpackField(rotnew_conv, cellID, quadPtMap, data, pos);
+  unpackField(rot, cellID, quadPtMap, data, pos);
+  unpackField(twinfraction_conv, cellID, quadPtMap, data, pos);
+  unpackField(slipfraction_conv, cellID, quadPtMap, data, pos);
+  unpackField(twin_conv, cellID, quadPtMap, data, pos);
+  unpackField(twin_ouput, cellID, quadPtMap, data, pos);
+  unpackField(phase, cellID, quadPtMap, data, pos);
+  unpackField(CauchyStress, cellID, quadPtMap, data, pos);
+  unpackField(TinterStress, cellID, quadPtMap, data, pos);
+  unpackField(TinterStress_diff, cellID, quadPtMap, data, pos);
+  unpackField(stateVar_conv, cellID, quadPtMap, data, pos);
+  unpackField(VoxelData, cellID, quadPtMap, data, pos);
+  unpackField(TwinMaxFlag_conv, cellID, quadPtMap, data, pos);
+  unpackField(NumberOfTwinnedRegion_conv, cellID, quadPtMap, data, pos);
+  unpackField(ActiveTwinSystems_conv, cellID, quadPtMap, data, pos);
+  unpackField(TwinFlag_conv, cellID, quadPtMap, data, pos);
+  unpackField(TwinOutputfraction_conv, cellID, quadPtMap, data, pos);
+  unpackField(TotaltwinvfK, cellID, quadPtMap, data, pos);
+  unpackField(slipIncrement_iter, cellID, quadPtMap, data, pos);
+
+  //the iteration history restarts from the converged history of the cell
+  if (Fe_iter.size()>0) Fe_iter[cellID]=Fe_conv[cellID];
+  if (Fp_iter.size()>0) Fp_iter[cellID]=Fp_conv[cellID];
+  s_alpha_iter.copyCells(s_alpha_conv, cellID, cellID+1);
+  W_kh_iter.copyCells(W_kh_conv, cellID, cellID+1);
+  rot_iter.copyCells(rot_conv, cellID, cellID+1);
+  rotnew_iter.copyCells(rotnew_conv, cellID, cellID+1);
+  twinfraction_iter.copyCells(twinfraction_conv, cellID, cellID+1);
+  if (slipfraction_iter.size()>0) slipfraction_iter[cellID]=slipfraction_conv[cellID];
+  if (twin_iter.size()>0) twin_iter[cellID]=twin_conv[cellID];
+  stateVar_iter.copyCells(stateVar_conv, cellID, cellID+1);
+  if (TwinMaxFlag_iter.size()>0) TwinMaxFlag_iter[cellID]=TwinMaxFlag_conv[cellID];
+  if (NumberOfTwinnedRegion_iter.size()>0) NumberOfTwinnedRegion_iter[cellID]=NumberOfTwinnedRegion_conv[cellID];
+  if (ActiveTwinSystems_iter.size()>0) ActiveTwinSystems_iter[cellID]=ActiveTwinSystems_conv[cellID];
+  if (TwinFlag_iter.size()>0) TwinFlag_iter[cellID]=TwinFlag_conv[cellID];
+  if (TwinOutputfraction_iter.size()>0) TwinOutputfraction_iter[cellID]=TwinOutputfraction_conv[cellID];
+}
+
+//mean plastic deformation (norm of Fp-I) of a cell, used as the adaptive refinement indicator
+template <int dim>
+double crystalPlasticity<dim>::getCellRefinementIndicator(unsigned int cellID)
+{
+  if (Fp_conv.size()==0) return 0.0;
+  double indicator=0.0;
+  FullMatrix<double> Fp(dim,dim);
+  for (unsigned int q=0; q<Fp_conv[cellID].size(); q++){
+    Fp=Fp_conv[cellID][q];
+    for (unsigned int i=0; i<dim; i++) Fp(i,i)-=1.0;
+    indicator+=Fp.frobenius_norm();
+  }
+  return indicator/Fp_conv[cellID].size();
+}
+
+#include "../../../include/crystalPlasticity_template_instantiations.h"
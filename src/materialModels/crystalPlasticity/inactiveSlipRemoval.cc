@@ -1,126 +1,181 @@
 #include "../../../include/crystalPlasticity.h"
 
-template <int dim>
-void crystalPlasticity<dim>::inactive_slip_removal(Vector<double> &active, Vector<double> &x_beta_old, Vector<double> &x_beta, unsigned int &n_PA, unsigned int &n_Tslip_systems_Region, Vector<double> &PA, Vector<double> b,FullMatrix<double> A,FullMatrix<double> &A_PA){
-
-    Vector<double> inactive;
-
-    FullMatrix<double> temp,temp2;
-    LAPACKFullMatrix<double> temp7;
-    temp7.reinit(n_PA,n_PA);
-    int iter=0,iter1=0,iter2=0,iter3=0;
-    Vector<double> x_beta1(n_PA), x_beta2(n_PA),b_PA(n_PA);
-    double flag1=0;
-    A_PA.reinit(n_PA,n_PA);
+namespace {
+    //in place Gauss-Jordan inversion with row pivoting, returns false for a (numerically) singular matrix
+    bool gaussJordanInverse(FullMatrix<double> &M){
+        const unsigned int N=M.m();
+        double maxEntry=0.0;
+        for(unsigned int i=0;i<N;i++)
+        for(unsigned int j=0;j<N;j++) maxEntry=std::max(maxEntry,std::abs(M(i,j)));
+        const double tol=1.0e-14*maxEntry;
+
+        std::vector<unsigned int> p(N);
+        for(unsigned int i=0;i<N;i++) p[i]=i;
+
+        for(unsigned int j=0;j<N;j++){
+            //pivot search in column j
+            double max=std::abs(M(j,j));
+            unsigned int r=j;
+            for(unsigned int i=j+1;i<N;i++){
+                if(std::abs(M(i,j))>max){
+                    max=std::abs(M(i,j));
+                    r=i;
+                }
+            }
+            if(max<=tol) return false;
 
-    for(unsigned int i=0;i<n_PA;i++){
-        b_PA(i)=b(PA(i));
-        for(unsigned int j=0;j<n_PA;j++){
-            A_PA[i][j]=A[PA(i)][PA(j)];
-            temp7(i,j)=A[PA(i)][PA(j)];
+            //row interchange
+            if(r>j){
+                for(unsigned int k=0;k<N;k++) std::swap(M(j,k),M(r,k));
+                std::swap(p[j],p[r]);
+            }
 
+            //transformation
+            const double hr=1.0/M(j,j);
+            M(j,j)=hr;
+            for(unsigned int k=0;k<N;k++){
+                if(k==j) continue;
+                for(unsigned int i=0;i<N;i++){
+                    if(i==j) continue;
+                    M(i,k)-=M(i,j)*M(j,k)*hr;
+                }
+            }
+            for(unsigned int i=0;i<N;i++){
+                M(i,j)*=hr;
+                M(j,i)*=-hr;
+            }
+            M(j,j)=hr;
         }
 
+        //column interchange
+        std::vector<double> hv(N);
+        for(unsigned int i=0;i<N;i++){
+            for(unsigned int k=0;k<N;k++) hv[p[k]]=M(i,k);
+            for(unsigned int k=0;k<N;k++) M(i,k)=hv[k];
+        }
+        return true;
     }
-    temp.reinit(n_PA,n_PA); temp2.reinit(n_PA,n_PA);
-    temp7.compute_inverse_svd(0.0);
-    Vector<double> tempv3;
-    temp7.vmult(x_beta1,b_PA);
 
-    x_beta2=x_beta1; x_beta1.reinit(n_Tslip_systems_Region);
-    x_beta1=0;
-    for(unsigned int i=0;i<n_PA;i++){
-        x_beta1(PA(i))=x_beta2(i);
+    //inverse of the active block, by Gauss-Jordan elimination or, if the block is singular,
+    //by the SVD pseudo-inverse
+    void invertActiveBlock(const FullMatrix<double> &A_PA, FullMatrix<double> &invA_PA){
+        invA_PA=A_PA;
+        if(gaussJordanInverse(invA_PA)) return;
+
+        const unsigned int N=A_PA.m();
+        LAPACKFullMatrix<double> temp7(N,N);
+        temp7=A_PA;
+        temp7.compute_inverse_svd(0.0);
+        for(unsigned int i=0;i<N;i++)
+        for(unsigned int j=0;j<N;j++) invA_PA(i,j)=temp7(i,j);
+    }
+}
 
+template <int dim>
+void crystalPlasticity<dim>::inactive_slip_removal(Vector<double> &active, Vector<double> &x_beta_old, Vector<double> &x_beta, unsigned int &n_PA, unsigned int &n_Tslip_systems_Region, Vector<double> &PA, const Vector<double> &b, const FullMatrix<double> &A, FullMatrix<double> &A_PA){
 
+    //The inverse of the active block is computed once. When slip systems R are removed from the
+    //active set, the inverse of the remaining block K follows from the current inverse B as
+    //inv(A_KK) = B_KK - B_KR*inv(B_RR)*B_RK, which only requires the inverse of the small block B_RR.
+    A_PA.reinit(n_PA,n_PA);
+    for(unsigned int i=0;i<n_PA;i++){
+        for(unsigned int j=0;j<n_PA;j++){
+            A_PA[i][j]=A[PA(i)][PA(j)];
+        }
     }
+    FullMatrix<double> invA_PA(n_PA,n_PA);
+    invertActiveBlock(A_PA,invA_PA);
 
+    Vector<double> x_beta1(n_Tslip_systems_Region), x_beta2, b_PA;
+    std::vector<unsigned int> keep, removed;
 
+    // Continue the process till removal of all inactive slip systems
+    while (true){
 
-    Vector<double> row,PA_new,inactive2;
-    double n_IA_new;
+        if(n_PA==0){
+            x_beta1=0.0;
+            break;
+        }
 
-    // Continue the process till removal of all inactive slip systems
-    while (flag1==0){
+        //incremental shear strains of the active slip systems
+        b_PA.reinit(n_PA); x_beta2.reinit(n_PA);
+        for(unsigned int i=0;i<n_PA;i++){
+            b_PA(i)=b(PA(i));
+        }
+        invA_PA.vmult(x_beta2,b_PA);
 
-        iter=0;
-        for(unsigned int i=0;i<n_Tslip_systems_Region;i++){
-            if((x_beta_old(i)+x_beta1(i))<0){
-                iter++;
-            }
+        x_beta1=0.0;
+        for(unsigned int i=0;i<n_PA;i++){
+            x_beta1(PA(i))=x_beta2(i);
         }
 
-        if(iter>0){
+        //active slip systems with a negative total shear strain increment are removed
+        keep.clear(); removed.clear();
+        for(unsigned int i=0;i<n_PA;i++){
+            if((x_beta_old(PA(i))+x_beta2(i))<0)
+            removed.push_back(i);
+            else
+            keep.push_back(i);
+        }
 
-            row.reinit(iter);
-            iter=0;
-            for(unsigned int i=0;i<n_Tslip_systems_Region;i++){
-                if((x_beta_old(i)+x_beta1(i))<0){
-                    row(iter)=i;
-                    iter++;
-                }
-            }
+        if(removed.size()==0)
+        break;
 
-            n_IA_new=iter;
-            PA_new.reinit(n_PA-n_IA_new);
-            iter2=0; iter=0;
-            for(unsigned int i=0;i<n_PA;i++){
-                for(unsigned int j=0;j<n_IA_new;j++){
-                    if(PA(i) != row(j)){
-                        iter++;
-                    }
-                }
+        const unsigned int n_K=keep.size(), n_R=removed.size();
 
-                if(iter==n_IA_new){
-                    PA_new(iter2)=PA(i);
-                    iter2++;
+        //downdate the inverse to the remaining active slip systems
+        FullMatrix<double> invB_RR(n_R,n_R), invA_KK(n_K,n_K);
+        for(unsigned int i=0;i<n_R;i++){
+            for(unsigned int j=0;j<n_R;j++){
+                invB_RR(i,j)=invA_PA(removed[i],removed[j]);
+            }
+        }
+        bool downdated=gaussJordanInverse(invB_RR);
+        if(downdated){
+            FullMatrix<double> temp(n_R,n_K);
+            for(unsigned int i=0;i<n_R;i++){
+                for(unsigned int j=0;j<n_K;j++){
+                    temp(i,j)=0.0;
+                    for(unsigned int k=0;k<n_R;k++){
+                        temp(i,j)+=invB_RR(i,k)*invA_PA(removed[k],keep[j]);
+                    }
                 }
-                iter=0;
-
             }
-
-            PA.reinit(n_PA-n_IA_new); PA=PA_new;
-
-            A_PA.reinit(n_PA-n_IA_new,n_PA-n_IA_new); A_PA=0.0;
-            b_PA.reinit(n_PA-n_IA_new); b_PA=0.0;
-
-            temp7.reinit((n_PA-n_IA_new),(n_PA-n_IA_new));
-            for(unsigned int i=0;i<(n_PA-n_IA_new);i++){
-                b_PA(i)=b(PA(i));
-                for(unsigned int j=0;j<(n_PA-n_IA_new);j++){
-                    A_PA[i][j]=A[PA(i)][PA(j)];
-                    temp7(i,j)=A[PA(i)][PA(j)];
-
+            for(unsigned int i=0;i<n_K;i++){
+                for(unsigned int j=0;j<n_K;j++){
+                    invA_KK(i,j)=invA_PA(keep[i],keep[j]);
+                    for(unsigned int k=0;k<n_R;k++){
+                        invA_KK(i,j)-=invA_PA(keep[i],removed[k])*temp(k,j);
+                    }
                 }
-
             }
+        }
 
+        Vector<double> PA_new(n_K);
+        for(unsigned int i=0;i<n_K;i++){
+            PA_new(i)=PA(keep[i]);
+        }
+        PA.reinit(n_K); PA=PA_new;
+        n_PA=n_K;
 
-            temp7.compute_inverse_svd(0.0);
-
-            x_beta1.reinit(n_PA-n_IA_new); temp7.vmult(x_beta1,b_PA);
-            x_beta2.reinit(n_PA-n_IA_new); x_beta2=x_beta1;
-            x_beta1.reinit(n_Tslip_systems_Region);x_beta1=0.0;
-            n_PA=n_PA-n_IA_new;
-
-            for(unsigned int i=0;i<n_PA;i++){
-                x_beta1(PA(i))=x_beta2(i);
+        A_PA.reinit(n_PA,n_PA);
+        for(unsigned int i=0;i<n_PA;i++){
+            for(unsigned int j=0;j<n_PA;j++){
+                A_PA[i][j]=A[PA(i)][PA(j)];
             }
-
         }
 
+        //the inverse is recomputed if the removed block is singular
+        if(downdated)
+        invA_PA=invA_KK;
         else
-            flag1=1;
-
+        invertActiveBlock(A_PA,invA_PA);
     }
 
     active.reinit(n_PA); active=PA;
     x_beta.reinit(n_Tslip_systems_Region); x_beta=x_beta1;
     x_beta_old.add(1.0,x_beta);
 
-
-
-
 }
 
 #include "../../../include/crystalPlasticity_template_instantiations.h"
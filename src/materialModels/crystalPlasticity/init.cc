@@ -67,6 +67,7 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
     std::cout << "Unable to open latent hardening ratio file \n";
     exit(1);
   }
+  compressLatentHardening(q_phase1,qBlocks_phase1);
 
 
   //open data file to read slip normals
@@ -203,10 +204,10 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
     rotnew_init(i)=0.0;
   }
 
-  rot_conv.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,rot_init));
-  rotnew_conv.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,rotnew_init));
-  rot_iter.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,rot_init));
-  rotnew_iter.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,rotnew_init));
+  rot_conv.reinit(num_local_cells,num_quad_points,rot_init,singlePrecisionHistory("orientation"));
+  rotnew_conv.reinit(num_local_cells,num_quad_points,rotnew_init,singlePrecisionHistory("orientation"));
+  rot_iter.reinit(num_local_cells,num_quad_points,rot_init,singlePrecisionHistory("orientation"));
+  rotnew_iter.reinit(num_local_cells,num_quad_points,rotnew_init,singlePrecisionHistory("orientation"));
   phase.resize(num_local_cells,std::vector<unsigned int>(num_quad_points,1));
   if (this->userInputs.enableMultiphase){
     numberofPhases=this->userInputs.numberofPhases;
@@ -224,18 +225,20 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
   //load rot, rotnew and VoxelData
   for (unsigned int cell=0; cell<num_local_cells; cell++){
     unsigned int materialID=cellOrientationMap[cell];
+    //view into the node shared euler angles table
+    const double* grainEulerAngles=orientations.getEulerAngles(materialID);
     for (unsigned int q=0; q<num_quad_points; q++){
       for (unsigned int i=0; i<dim; i++){
-        rot_iter[cell][q][i]=orientations.eulerAngles[materialID][i];
-        rotnew_iter[cell][q][i]=orientations.eulerAngles[materialID][i];
+        rot_iter.set(cell,q,i,grainEulerAngles[i]);
+        rotnew_iter.set(cell,q,i,grainEulerAngles[i]);
       }
       if (this->userInputs.enableMultiphase){
-        phase[cell][q]=orientations.eulerAngles[materialID][3];
+        phase[cell][q]=grainEulerAngles[3];
         counter=1;
       }
       if (numberOfAdditionalVoxelInfo>0){
         for (unsigned int i=dim+counter; i<dim+counter+this->userInputs.additionalVoxelInfo; i++){
-          VoxelData[cell][q][i-dim-counter]=orientations.eulerAngles[materialID][i];
+          VoxelData[cell][q][i-dim-counter]=grainEulerAngles[i];
         }
       }
     }
@@ -303,26 +306,28 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
     //Resize the vectors of history variables
     Fp_conv.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,IdentityMatrix(dim)));
     Fe_conv.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,IdentityMatrix(dim)));
-    s_alpha_conv.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,s0_init));
-    W_kh_conv.resize(num_local_cells, std::vector<Vector<double> >(num_quad_points, W_kh_init));
-    W_kh_iter.resize(num_local_cells, std::vector<Vector<double> >(num_quad_points, W_kh_init));
+    s_alpha_conv.reinit(num_local_cells,num_quad_points,s0_init,singlePrecisionHistory("slip resistance"));
+    W_kh_conv.reinit(num_local_cells,num_quad_points,W_kh_init,singlePrecisionHistory("backstress"));
+    W_kh_iter.reinit(num_local_cells,num_quad_points,W_kh_init,singlePrecisionHistory("backstress"));
     Fp_iter.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,IdentityMatrix(dim)));
     Fe_iter.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,IdentityMatrix(dim)));
     CauchyStress.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,CauchyStress_init));
 	 TinterStress.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,TinterStress_init));
 	 TinterStress_diff.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,TinterStress_diff_init));
-    s_alpha_iter.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,s0_init));
-    twinfraction_iter.resize(num_local_cells,std::vector<std::vector<double> >(num_quad_points,twin_init));
+    s_alpha_iter.reinit(num_local_cells,num_quad_points,s0_init,singlePrecisionHistory("slip resistance"));
+    twinfraction_iter.reinit(num_local_cells,num_quad_points,twin_init,singlePrecisionHistory("twin fraction"));
     slipfraction_iter.resize(num_local_cells,std::vector<std::vector<double> >(num_quad_points,slip_init));
-    twinfraction_conv.resize(num_local_cells,std::vector<std::vector<double> >(num_quad_points,twin_init));
+    //slip increments of the last solve are only stored for the warm start of the active slip search
+    if (this->userInputs.enableSlipWarmStart) slipIncrement_iter.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points));
+    twinfraction_conv.reinit(num_local_cells,num_quad_points,twin_init,singlePrecisionHistory("twin fraction"));
     slipfraction_conv.resize(num_local_cells,std::vector<std::vector<double> >(num_quad_points,slip_init));
     twin_ouput.resize(num_local_cells, std::vector<double>(num_quad_points,0.0));
     twin_conv.resize(num_local_cells,std::vector<unsigned int>(num_quad_points,0));
     twin_iter.resize(num_local_cells,std::vector<unsigned int>(num_quad_points,0));
 
     if (this->userInputs.enableUserMaterialModel){
-      stateVar_conv.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,stateVar_init));
-      stateVar_iter.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,stateVar_init));
+      stateVar_conv.reinit(num_local_cells,num_quad_points,stateVar_init,singlePrecisionHistory("state variables"));
+      stateVar_iter.reinit(num_local_cells,num_quad_points,stateVar_init,singlePrecisionHistory("state variables"));
     }
   }
 
@@ -507,6 +512,7 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
         std::cout << "Unable to open latent hardening ratio file 2 \n";
         exit(1);
       }
+      compressLatentHardening(q_phase2,qBlocks_phase2);
 
 
       //open data file to read slip normals
@@ -646,6 +652,7 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
           std::cout << "Unable to open latent hardening ratio file 3 \n";
           exit(1);
         }
+        compressLatentHardening(q_phase3,qBlocks_phase3);
 
 
         //open data file to read slip normals
@@ -786,6 +793,7 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
             std::cout << "Unable to open latent hardening ratio file 4\n";
             exit(1);
           }
+          compressLatentHardening(q_phase4,qBlocks_phase4);
 
 
           //open data file to read slip normals
@@ -982,8 +990,8 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
       for (unsigned int i=0;i<Max_n_UserMatStateVar_MultiPhase;i++){
         stateVar_init1(i)=0.0;
       }
-      stateVar_conv.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,stateVar_init1));
-      stateVar_iter.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,stateVar_init1));
+      stateVar_conv.reinit(num_local_cells,num_quad_points,stateVar_init1,singlePrecisionHistory("state variables"));
+      stateVar_iter.reinit(num_local_cells,num_quad_points,stateVar_init1,singlePrecisionHistory("state variables"));
       for (unsigned int i=0;i<n_UserMatStateVar_MultiPhase[0];i++){
         stateVar_init1(i)=stateVar_init(i);
       }
@@ -999,13 +1007,15 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
     CauchyStress.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,CauchyStress_init));
 	TinterStress.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,TinterStress_init));
 	TinterStress_diff.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,TinterStress_diff_init));
-    s_alpha_conv.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,s0_init1));
-    W_kh_conv.resize(num_local_cells, std::vector<Vector<double> >(num_quad_points, W_kh_init1));
-    W_kh_iter.resize(num_local_cells, std::vector<Vector<double> >(num_quad_points, W_kh_init1));
-    s_alpha_iter.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,s0_init1));
-    twinfraction_iter.resize(num_local_cells,std::vector<std::vector<double> >(num_quad_points,twin_init1));
+    s_alpha_conv.reinit(num_local_cells,num_quad_points,s0_init1,singlePrecisionHistory("slip resistance"));
+    W_kh_conv.reinit(num_local_cells,num_quad_points,W_kh_init1,singlePrecisionHistory("backstress"));
+    W_kh_iter.reinit(num_local_cells,num_quad_points,W_kh_init1,singlePrecisionHistory("backstress"));
+    s_alpha_iter.reinit(num_local_cells,num_quad_points,s0_init1,singlePrecisionHistory("slip resistance"));
+    twinfraction_iter.reinit(num_local_cells,num_quad_points,twin_init1,singlePrecisionHistory("twin fraction"));
     slipfraction_iter.resize(num_local_cells,std::vector<std::vector<double> >(num_quad_points,slip_init1));
-    twinfraction_conv.resize(num_local_cells,std::vector<std::vector<double> >(num_quad_points,twin_init1));
+    //slip increments of the last solve are only stored for the warm start of the active slip search
+    if (this->userInputs.enableSlipWarmStart) slipIncrement_iter.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points));
+    twinfraction_conv.reinit(num_local_cells,num_quad_points,twin_init1,singlePrecisionHistory("twin fraction"));
     slipfraction_conv.resize(num_local_cells,std::vector<std::vector<double> >(num_quad_points,slip_init1));
     twin_ouput.resize(num_local_cells, std::vector<double>(num_quad_points,0.0));
     twin_conv.resize(num_local_cells,std::vector<unsigned int>(num_quad_points,0));
@@ -1125,50 +1135,50 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
         phaseMaterial=phase[cell][q];
         if (phaseMaterial==1){
           for (unsigned int i=0; i<Max_n_Tslip_systems_MultiPhase; i++){
-            s_alpha_conv[cell][q][i]=s0_init1(i);
-            s_alpha_iter[cell][q][i]=s0_init1(i);
+            s_alpha_conv.set(cell,q,i,s0_init1(i));
+            s_alpha_iter.set(cell,q,i,s0_init1(i));
           }
           if ((this->userInputs.enableUserMaterialModel)&&(this->userInputs.enableUserMaterialModel1)){
             for (unsigned int i=0; i<Max_n_UserMatStateVar_MultiPhase; i++){
-              stateVar_conv[cell][q][i]=stateVar_init1(i);
-              stateVar_iter[cell][q][i]=stateVar_init1(i);
+              stateVar_conv.set(cell,q,i,stateVar_init1(i));
+              stateVar_iter.set(cell,q,i,stateVar_init1(i));
             }
           }
 
         }
         else if (phaseMaterial==2){
           for (unsigned int i=0; i<Max_n_Tslip_systems_MultiPhase; i++){
-            s_alpha_conv[cell][q][i]=s0_init2(i);
-            s_alpha_iter[cell][q][i]=s0_init2(i);
+            s_alpha_conv.set(cell,q,i,s0_init2(i));
+            s_alpha_iter.set(cell,q,i,s0_init2(i));
           }
           if ((this->userInputs.enableUserMaterialModel)&&(this->userInputs.enableUserMaterialModel2)){
             for (unsigned int i=0; i<Max_n_UserMatStateVar_MultiPhase; i++){
-              stateVar_conv[cell][q][i]=stateVar_init2(i);
-              stateVar_iter[cell][q][i]=stateVar_init2(i);
+              stateVar_conv.set(cell,q,i,stateVar_init2(i));
+              stateVar_iter.set(cell,q,i,stateVar_init2(i));
             }
           }
         }
         else if (phaseMaterial==3){
           for (unsigned int i=0; i<Max_n_Tslip_systems_MultiPhase; i++){
-            s_alpha_conv[cell][q][i]=s0_init3(i);
-            s_alpha_iter[cell][q][i]=s0_init3(i);
+            s_alpha_conv.set(cell,q,i,s0_init3(i));
+            s_alpha_iter.set(cell,q,i,s0_init3(i));
           }
           if ((this->userInputs.enableUserMaterialModel)&&(this->userInputs.enableUserMaterialModel3)){
             for (unsigned int i=0; i<Max_n_UserMatStateVar_MultiPhase; i++){
-              stateVar_conv[cell][q][i]=stateVar_init3(i);
-              stateVar_iter[cell][q][i]=stateVar_init3(i);
+              stateVar_conv.set(cell,q,i,stateVar_init3(i));
+              stateVar_iter.set(cell,q,i,stateVar_init3(i));
             }
           }
         }
         else if (phaseMaterial==4){
           for (unsigned int i=0; i<Max_n_Tslip_systems_MultiPhase; i++){
-            s_alpha_conv[cell][q][i]=s0_init4(i);
-            s_alpha_iter[cell][q][i]=s0_init4(i);
+            s_alpha_conv.set(cell,q,i,s0_init4(i));
+            s_alpha_iter.set(cell,q,i,s0_init4(i));
           }
           if ((this->userInputs.enableUserMaterialModel)&&(this->userInputs.enableUserMaterialModel4)){
             for (unsigned int i=0; i<Max_n_UserMatStateVar_MultiPhase; i++){
-              stateVar_conv[cell][q][i]=stateVar_init4(i);
-              stateVar_iter[cell][q][i]=stateVar_init4(i);
+              stateVar_conv.set(cell,q,i,stateVar_init4(i));
+              stateVar_iter.set(cell,q,i,stateVar_init4(i));
             }
           }
         }
@@ -1178,9 +1188,21 @@ void crystalPlasticity<dim>::init(unsigned int num_quad_points)
 
   }
 
+  if (this->userInputs.writeGrainAveragedOutput){
+    initGrainAveragedOutput();
+  }
+
   N_qpts=num_quad_points;
   initCalled=true;
 
 }
 
+//history fields listed in "Single precision history fields" are stored in single precision
+template <int dim>
+bool crystalPlasticity<dim>::singlePrecisionHistory(const std::string &fieldName) const
+{
+  const std::vector<std::string> &fields=this->userInputs.singlePrecisionHistoryFields;
+  return std::find(fields.begin(), fields.end(), fieldName)!=fields.end();
+}
+
 #include "../../../include/crystalPlasticity_template_instantiations.h"
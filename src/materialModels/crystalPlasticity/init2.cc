@@ -291,18 +291,18 @@ void crystalPlasticity<dim>::init2(unsigned int num_quad_points)
   Fp_iter.resize(num_local_cells, std::vector<FullMatrix<double> >(num_quad_points, Fp_conv_init));
   Fe_iter.resize(num_local_cells, std::vector<FullMatrix<double> >(num_quad_points, Fp_conv_init));
   CauchyStress.resize(num_local_cells,std::vector<FullMatrix<double> >(num_quad_points,CauchyStress_init));
-  s_alpha_conv.resize(num_local_cells, std::vector<Vector<double> >(num_quad_points, s0_init));
-  s_alpha_iter.resize(num_local_cells, std::vector<Vector<double> >(num_quad_points, s0_init));
+  s_alpha_conv.reinit(num_local_cells,num_quad_points,s0_init,singlePrecisionHistory("slip resistance"));
+  s_alpha_iter.reinit(num_local_cells,num_quad_points,s0_init,singlePrecisionHistory("slip resistance"));
   slipfraction_iter.resize(num_local_cells, std::vector<std::vector<double> >(num_quad_points, slip_init));
   slipfraction_conv.resize(num_local_cells, std::vector<std::vector<double> >(num_quad_points, slip_init));
   TwinOutputfraction_iter.resize(num_local_cells, std::vector<std::vector<double> >(num_quad_points, TwinOutput_init));
   TwinOutputfraction_conv.resize(num_local_cells, std::vector<std::vector<double> >(num_quad_points, TwinOutput_init));
   rot.resize(num_local_cells, std::vector<Vector<double> >(num_quad_points, rot_init));
-  rotnew_conv.resize(num_local_cells, std::vector<Vector<double> >(num_quad_points, rotnew_init));
-  rotnew_iter.resize(num_local_cells, std::vector<Vector<double> >(num_quad_points, rotnew_init));
+  rotnew_conv.reinit(num_local_cells,num_quad_points,rotnew_init,singlePrecisionHistory("orientation"));
+  rotnew_iter.reinit(num_local_cells,num_quad_points,rotnew_init,singlePrecisionHistory("orientation"));
 
-  twinfraction_iter.resize(num_local_cells,std::vector<std::vector<double> >(num_quad_points,twin_init));
-  twinfraction_conv.resize(num_local_cells,std::vector<std::vector<double> >(num_quad_points,twin_init));
+  twinfraction_iter.reinit(num_local_cells,num_quad_points,twin_init,singlePrecisionHistory("twin fraction"));
+  twinfraction_conv.reinit(num_local_cells,num_quad_points,twin_init,singlePrecisionHistory("twin fraction"));
   twin_ouput.resize(num_local_cells, std::vector<double>(num_quad_points,0.0));
   TwinMaxFlag_conv.resize(num_local_cells, std::vector<unsigned int>(num_quad_points, 1));
   TwinFlag_conv.resize(num_local_cells, std::vector<std::vector<unsigned int> >(num_quad_points, twin_init2));
@@ -315,21 +315,21 @@ void crystalPlasticity<dim>::init2(unsigned int num_quad_points)
   NumberOfTwinnedRegion_iter.resize(num_local_cells, std::vector<unsigned int>(num_quad_points, 0));
 
   if (this->userInputs.enableUserMaterialModel){
-      stateVar_conv.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,stateVar_init));
-      stateVar_iter.resize(num_local_cells,std::vector<Vector<double> >(num_quad_points,stateVar_init));
+      stateVar_conv.reinit(num_local_cells,num_quad_points,stateVar_init,singlePrecisionHistory("state variables"));
+      stateVar_iter.reinit(num_local_cells,num_quad_points,stateVar_init,singlePrecisionHistory("state variables"));
   }
 
   double s0_twin=this->userInputs.initialSlipResistanceTwin1[n_twin_systems-1];
   for (unsigned int cell = 0; cell<num_local_cells; cell++) {
     for (unsigned int region = 1; region<(n_twin_systems / 2) + 1; region++) {
       for (unsigned int q = 0; q<num_quad_points; q++) {
-        s_alpha_conv[cell][q][region*n_slip_systems+n_slip_systemsWOtwin] = s0_twin;
-        s_alpha_iter[cell][q][region*n_slip_systems+n_slip_systemsWOtwin] = s0_twin;
-        s_alpha_conv[cell][q][region*n_slip_systems+n_slip_systemsWOtwin+1] = s0_twin;
-        s_alpha_iter[cell][q][region*n_slip_systems+n_slip_systemsWOtwin+1] = s0_twin;
+        s_alpha_conv.set(cell,q,region*n_slip_systems+n_slip_systemsWOtwin,s0_twin);
+        s_alpha_iter.set(cell,q,region*n_slip_systems+n_slip_systemsWOtwin,s0_twin);
+        s_alpha_conv.set(cell,q,region*n_slip_systems+n_slip_systemsWOtwin+1,s0_twin);
+        s_alpha_iter.set(cell,q,region*n_slip_systems+n_slip_systemsWOtwin+1,s0_twin);
         for (unsigned int i = n_slip_systemsWOtwin + 2; i < n_slip_systems; i++) {
-          s_alpha_conv[cell][q][region*n_slip_systems+i] = 0;
-          s_alpha_iter[cell][q][region*n_slip_systems+i] = 0;
+          s_alpha_conv.set(cell,q,region*n_slip_systems+i,0);
+          s_alpha_iter.set(cell,q,region*n_slip_systems+i,0);
         }
       }
     }
@@ -341,11 +341,13 @@ void crystalPlasticity<dim>::init2(unsigned int num_quad_points)
   //load rot and rotnew
   for (unsigned int cell=0; cell<num_local_cells; cell++){
     unsigned int materialID=cellOrientationMap[cell];
+    //view into the node shared euler angles table
+    const double* grainEulerAngles=orientations.getEulerAngles(materialID);
     for (unsigned int q=0; q<num_quad_points; q++){
       for (unsigned int i = 0; i<dim; i++){
-        rot[cell][q][i]=orientations.eulerAngles[materialID][i];
-        rotnew_iter[cell][q][i]=orientations.eulerAngles[materialID][i];
-        rotnew_conv[cell][q][i] = orientations.eulerAngles[materialID][i];
+        rot[cell][q][i]=grainEulerAngles[i];
+        rotnew_iter.set(cell,q,i,grainEulerAngles[i]);
+        rotnew_conv.set(cell,q,i,grainEulerAngles[i]);
       }
       for (unsigned int Region = 1; Region<(n_twin_systems / 2) + 1; Region++) {
 
@@ -357,13 +359,17 @@ void crystalPlasticity<dim>::init2(unsigned int num_quad_points)
         quatproduct(quatprod, quat2, quat1);
         quat2rod(quatprod, rod);
         rot[cell][q][Region*dim] = rod(0);rot[cell][q][Region*dim+1] = rod(1);rot[cell][q][Region*dim+2] = rod(2);
-        rotnew_iter[cell][q][Region*dim] = rod(0);rotnew_iter[cell][q][Region*dim+1] = rod(1);rotnew_iter[cell][q][Region*dim+2] = rod(2);
-        rotnew_conv[cell][q][Region*dim] = rod(0);rotnew_conv[cell][q][Region*dim+1] = rod(1);rotnew_conv[cell][q][Region*dim+2] = rod(2);
+        rotnew_iter.set(cell,q,Region*dim,rod(0));rotnew_iter.set(cell,q,Region*dim+1,rod(1));rotnew_iter.set(cell,q,Region*dim+2,rod(2));
+        rotnew_conv.set(cell,q,Region*dim,rod(0));rotnew_conv.set(cell,q,Region*dim+1,rod(1));rotnew_conv.set(cell,q,Region*dim+2,rod(2));
       }
 
     }
   }
 
+  if (this->userInputs.writeGrainAveragedOutput){
+    initGrainAveragedOutput();
+  }
+
   N_qpts=num_quad_points;
   initCalled=true;
 
@@ -0,0 +1,99 @@
+#include "../../../include/crystalPlasticity.h"
+
+//Latent hardening ratios read from the latent hardening ratio file have a block structure: the ratio
+//between two different systems only depends on the groups of the two systems (e.g. coplanar and
+//non-coplanar slip systems, slip and twin systems). The systems are grouped such that every
+//off-diagonal ratio is given by the ratio between the groups of its row and column, and the
+//self hardening ratios are stored separately. If no such grouping exists, every system is its own
+//group, which reproduces the dense matrix.
+template <int dim>
+void crystalPlasticity<dim>::compressLatentHardening(const FullMatrix<double> &q_phase, latentHardeningBlocks &blocks)
+{
+  const unsigned int n=q_phase.m();
+  double maxRatio=0.0;
+  for (unsigned int i=0;i<n;i++)
+  for (unsigned int j=0;j<n;j++) maxRatio=std::max(maxRatio,std::abs(q_phase(i,j)));
+  const double tol=1.0e-12*maxRatio;
+
+  //system i joins the group of representative r if the rows and columns of i and r agree outside
+  //of the entries (i,r) and (r,i), and the ratio between i and r is the one inside the group
+  std::vector<unsigned int> representative;
+  std::vector<int> innerMember;
+  blocks.group.assign(n,0);
+  for (unsigned int i=0;i<n;i++){
+    bool assigned=false;
+    for (unsigned int g=0;(g<representative.size())&&!assigned;g++){
+      const unsigned int r=representative[g];
+      bool compatible=(std::abs(q_phase(i,r)-q_phase(r,i))<=tol);
+      if (innerMember[g]>=0){
+        const unsigned int s=innerMember[g];
+        compatible=compatible&&(std::abs(q_phase(i,r)-q_phase(r,s))<=tol);
+      }
+      for (unsigned int j=0;(j<n)&&compatible;j++){
+        if ((j==i)||(j==r)) continue;
+        if ((std::abs(q_phase(i,j)-q_phase(r,j))>tol)||(std::abs(q_phase(j,i)-q_phase(j,r))>tol)) compatible=false;
+      }
+      if (compatible){
+        blocks.group[i]=g;
+        if (innerMember[g]<0) innerMember[g]=i;
+        assigned=true;
+      }
+    }
+    if (!assigned){
+      blocks.group[i]=representative.size();
+      representative.push_back(i);
+      innerMember.push_back(-1);
+    }
+  }
+
+  unsigned int numGroups=representative.size();
+  blocks.blockRatio.reinit(numGroups,numGroups);
+  for (unsigned int g=0;g<numGroups;g++){
+    for (unsigned int h=0;h<numGroups;h++){
+      if (g!=h) blocks.blockRatio(g,h)=q_phase(representative[g],representative[h]);
+      else if (innerMember[g]>=0) blocks.blockRatio(g,h)=q_phase(representative[g],innerMember[g]);
+    }
+  }
+
+  //the grouping is checked against the dense matrix
+  bool exact=true;
+  for (unsigned int i=0;(i<n)&&exact;i++){
+    for (unsigned int j=0;j<n;j++){
+      if ((i!=j)&&(std::abs(blocks.blockRatio(blocks.group[i],blocks.group[j])-q_phase(i,j))>tol)){
+        exact=false;
+        break;
+      }
+    }
+  }
+  if (!exact){
+    numGroups=n;
+    blocks.blockRatio=q_phase;
+    for (unsigned int i=0;i<n;i++) blocks.group[i]=i;
+  }
+
+  blocks.selfRatio.reinit(n);
+  for (unsigned int i=0;i<n;i++) blocks.selfRatio(i)=q_phase(i,i);
+
+  this->pcout << "latent hardening ratios of " << n << " systems in " << numGroups << " blocks\n";
+}
+
+//result_i = sum_j q_ij*v_j with the latent hardening ratios q of the current phase, using the
+//sums of v over the groups: O(n*groups) instead of O(n^2)
+template <int dim>
+void crystalPlasticity<dim>::latentHardeningVmult(Vector<double> &result, const Vector<double> &v)
+{
+  const unsigned int n=v.size();
+  const unsigned int numGroups=qBlocks->blockRatio.m();
+  std::vector<double> groupSum(numGroups,0.0);
+  for (unsigned int j=0;j<n;j++) groupSum[qBlocks->group[j]]+=v(j);
+
+  result.reinit(n);
+  for (unsigned int i=0;i<n;i++){
+    const unsigned int g=qBlocks->group[i];
+    double value=(qBlocks->selfRatio(i)-qBlocks->blockRatio(g,g))*v(i);
+    for (unsigned int h=0;h<numGroups;h++) value+=qBlocks->blockRatio(g,h)*groupSum[h];
+    result(i)=value;
+  }
+}
+
+#include "../../../include/crystalPlasticity_template_instantiations.h"
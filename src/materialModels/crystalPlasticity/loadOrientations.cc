@@ -2,34 +2,38 @@
 
 template <int dim>
 void crystalPlasticity<dim>::loadOrientations(){
-    QGauss<dim>  quadrature(this->userInputs.quadOrder);
-    const unsigned int num_quad_points = quadrature.size();
-    FEValues<dim> fe_values (this->FE, quadrature, update_quadrature_points);
-    unsigned int gID;
-
-    //loop over elements
-    typename DoFHandler<dim>::active_cell_iterator cell = this->dofHandler.begin_active(), endc = this->dofHandler.end();
-    for (; cell!=endc; ++cell) {
-        if (cell->is_locally_owned()){
-
-            fe_values.reinit(cell);
+    //the grain ID lookups of the cells are independent and done by the threads over subranges of the cells
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+    this->getLocallyOwnedCells(this->dofHandler, cells);
+    const unsigned int num_local_cells = cells.size();
+    const unsigned int firstCellID = cellOrientationMap.size();
+    cellOrientationMap.resize(firstCellID+num_local_cells);
+
+    parallel::apply_to_subranges(0u, num_local_cells,
+      [&](const unsigned int begin, const unsigned int end){
+        for (unsigned int cellID=begin; cellID<end; cellID++){
             double pnt3[3];
-            const Point<dim> pnt2=cell->center();
+            const Point<dim> pnt2=cells[cellID]->center();
             for (unsigned int i=0; i<dim; ++i){
                 pnt3[i]=pnt2[i];
             }
 
-
-            if(this->userInputs.readExternalMesh)
-              gID=cell->material_id();
+            unsigned int gID;
+            if((this->userInputs.readExternalMesh)||(this->userInputs.voxelAlignedMesh))
+              gID=cells[cellID]->material_id();
             else
             //Do you want cell centers or quadrature
               gID=orientations.getMaterialID(pnt3);
 
-            cellOrientationMap.push_back(gID);
-
+            cellOrientationMap[firstCellID+cellID]=gID;
         }
-    }
+      }, this->getThreadGrainSize(num_local_cells));
+}
+
+//grain ID of a voxel of the voxel aligned mesh, read directly from the grain ID grid
+template <int dim>
+unsigned int crystalPlasticity<dim>::getVoxelGrainID(unsigned int voxelIndex[]){
+    return orientations.getVoxelMaterialID(voxelIndex);
 }
 
 #include "../../../include/crystalPlasticity_template_instantiations.h"
@@ -1,5 +1,22 @@
 #include "../../../include/crystalPlasticity.h"
 
+namespace {
+    //conversions between the dim x dim matrices and the fixed size tensors
+    Tensor<2,3,double> toTensor3(const FullMatrix<double> &A) {
+        Tensor<2,3,double> t;
+        for(unsigned int i=0;i<A.m();i++)
+        for(unsigned int j=0;j<A.n();j++) t[i][j]=A[i][j];
+        return t;
+    }
+
+    FullMatrix<double> toFullMatrix(const Tensor<2,3,double> &t, const unsigned int n) {
+        FullMatrix<double> A(n,n);
+        for(unsigned int i=0;i<n;i++)
+        for(unsigned int j=0;j<n;j++) A[i][j]=t[i][j];
+        return A;
+    }
+}
+
 
 template <int dim>
 void crystalPlasticity<dim>::tracev(FullMatrix<double> &Atrace, FullMatrix<double> elm, FullMatrix<double> B) {
@@ -162,26 +179,9 @@ void crystalPlasticity<dim>::matform(FullMatrix<double> &A, Vector<double> Av) {
 }
 
 template <int dim>
-FullMatrix<double> crystalPlasticity<dim>::matrixExponential(FullMatrix<double> A) {
-
-    FullMatrix<double> matExp(dim,dim),temp(dim,dim),temp2(dim,dim);
-    matExp=IdentityMatrix(dim);
-    temp=IdentityMatrix(dim);
-
-    double count=1;
+FullMatrix<double> crystalPlasticity<dim>::matrixExponential(const FullMatrix<double> &A) {
 
-    while(temp.frobenius_norm()>1.0e-10){
-
-        temp.mmult(temp2,A);
-        temp2.equ(1/count,temp2);
-        temp.equ(1.0,temp2);
-        matExp.add(1.0,temp);
-        count=count+1.0;
-
-
-    }
-
-    return matExp;
+    return toFullMatrix(matrixExponential3(toTensor3(A)),dim);
 
 }
 
@@ -234,7 +234,7 @@ void crystalPlasticity<dim>::elasticmoduli(FullMatrix<double> &Ar, FullMatrix<do
 }
 
 template <int dim>                  
-FullMatrix<double> crystalPlasticity<dim>::matrixExponential6(FullMatrix<double> A) {
+FullMatrix<double> crystalPlasticity<dim>::matrixExponential6(const FullMatrix<double> &A) {
 
 	FullMatrix<double> matExp(2*dim,2*dim),temp(2*dim,2*dim),temp2(2*dim,2*dim);
 	matExp=IdentityMatrix(2*dim);
@@ -255,64 +255,19 @@ FullMatrix<double> crystalPlasticity<dim>::matrixExponential6(FullMatrix<double>
 
 
 template <int dim>
-FullMatrix<double> crystalPlasticity<dim>::matrixExponentialGateauxDerivative(FullMatrix<double> A, FullMatrix<double> B) {
-
-	FullMatrix<double> matExp(2*dim,2*dim),matExpGatDer(dim,dim);
-	FullMatrix<double> C(2*dim,2*dim) ;
-	C = 0 ;
-	for(unsigned int i=0 ; i<3 ; i++){
-		for(unsigned int j=0 ; j<3 ; j++){
-			C[i][j] = A[i][j] ;
-			C[i+3][j+3] = A[i][j] ;
-			C[i][j+3] = B[i][j] ;	
-		}
-	}
+FullMatrix<double> crystalPlasticity<dim>::matrixExponentialGateauxDerivative(const FullMatrix<double> &A, const FullMatrix<double> &B) {
 
-	matExp.equ(1.0,matrixExponential6(C)) ;
-      
-	for(unsigned int i=0 ; i<3 ; i++){
-		for(unsigned int j=3 ; j<6 ; j++ ){
-			matExpGatDer[i][j-3] = matExp[i][j] ;
-		}
-	}
-
-
-
-	return matExpGatDer;
+	Tensor<2,3,double> expA, dExpA;
+	matrixExponentialAndGateauxDerivative3(toTensor3(A),toTensor3(B),expA,dExpA);
+	return toFullMatrix(dExpA,dim);
 }
 
 template <int dim>
-FullMatrix<double> crystalPlasticity<dim>::matrixExponentialGateauxDerivative2(FullMatrix<double> A, FullMatrix<double> B){
-	
-	FullMatrix<double> temp1(dim,dim),temp2(dim,dim),temp3(dim,dim),matExpGatDer(dim,dim), temp4(dim,dim),temp5(dim,dim);
-	double resdl = 1.0, count = 1.0, sctemp = 1.0 ;
-	temp1 = 0;
-	temp2.equ(1.0,B) ;
-	matExpGatDer.equ(1.0,temp1) ;
-	
-	
-	while(resdl > 1.0e-10){
-		sctemp = sctemp/count ;
-		matExpGatDer.add(sctemp,temp2) ;
-		temp3.equ(1.0,temp2) ;
-		temp1.mmult(temp4,A) ;
-		temp4.equ(-1.0,temp4) ;
-		temp4.add(1.0,temp2) ;
-		A.mmult(temp5,temp4) ;
-		temp2.mmult(temp4,A) ;
-		temp4.add(1.0,temp5) ;
-		temp2.equ(1.0,temp4) ;
-		temp1.equ(1.0,temp3) ;
-		
-		temp5.equ(sctemp/(count + 1.0),temp2) ;
-		resdl = temp5.frobenius_norm() ;
-		
-		count = count + 1.0 ;
-    }
+FullMatrix<double> crystalPlasticity<dim>::matrixExponentialGateauxDerivative2(const FullMatrix<double> &A, const FullMatrix<double> &B){
 
-	return matExpGatDer ;
-	
-	
+	Tensor<2,3,double> expA, dExpA;
+	matrixExponentialAndGateauxDerivative3(toTensor3(A),toTensor3(B),expA,dExpA);
+	return toFullMatrix(dExpA,dim);
 }
 
 
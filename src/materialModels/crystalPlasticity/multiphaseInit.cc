@@ -33,6 +33,7 @@ void crystalPlasticity<dim>::multiphaseInit(unsigned int cellID,
 
     q.reinit(n_Tslip_systems,n_Tslip_systems);
     q=q_phase1;
+    qBlocks=&qBlocks_phase1;
 
 
     twinShear=this->userInputs.twinShear1;
@@ -111,6 +112,7 @@ void crystalPlasticity<dim>::multiphaseInit(unsigned int cellID,
 
       q.reinit(n_Tslip_systems,n_Tslip_systems);
       q=q_phase1;
+      qBlocks=&qBlocks_phase1;
 
 
       twinShear=this->userInputs.twinShear1;
@@ -183,6 +185,7 @@ void crystalPlasticity<dim>::multiphaseInit(unsigned int cellID,
 
       q.reinit(n_Tslip_systems,n_Tslip_systems);
       q=q_phase2;
+      qBlocks=&qBlocks_phase2;
 
 
       twinShear=this->userInputs.twinShear2;
@@ -256,6 +259,7 @@ void crystalPlasticity<dim>::multiphaseInit(unsigned int cellID,
 
       q.reinit(n_Tslip_systems,n_Tslip_systems);
       q=q_phase3;
+      qBlocks=&qBlocks_phase3;
 
 
       twinShear=this->userInputs.twinShear3;
@@ -329,6 +333,7 @@ void crystalPlasticity<dim>::multiphaseInit(unsigned int cellID,
 
       q.reinit(n_Tslip_systems,n_Tslip_systems);
       q=q_phase4;
+      qBlocks=&qBlocks_phase4;
 
 
       twinShear=this->userInputs.twinShear4;
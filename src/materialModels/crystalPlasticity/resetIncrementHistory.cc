@@ -0,0 +1,31 @@
+#include "../../../include/crystalPlasticity.h"
+
+template <int dim>
+void crystalPlasticity<dim>::resetIncrementHistory()
+{
+  //Fe, Fp, s_alpha, W_kh, slip and twin fractions are recomputed from the _conv history
+  //at every iteration, so only the variables which are updated conditionally (twin
+  //reorientation and flags) are copied back from the last converged increment.
+  rot_iter=rot_conv;
+  rotnew_iter=rotnew_conv;
+  twin_iter=twin_conv;
+
+  if (this->userInputs.enableUserMaterialModel){
+    stateVar_iter=stateVar_conv;
+  }
+
+  if (this->userInputs.enableAdvancedTwinModel){
+    TwinMaxFlag_iter = TwinMaxFlag_conv;
+    NumberOfTwinnedRegion_iter = NumberOfTwinnedRegion_conv;
+    ActiveTwinSystems_iter = ActiveTwinSystems_conv;
+    TwinFlag_iter = TwinFlag_conv;
+    TwinOutputfraction_iter=TwinOutputfraction_conv;
+  }
+
+  //updateBeforeIncrement() has already advanced Fprev for this increment
+  if(this->userInputs.useVelocityGrad){
+    this->Fprev.add(-1,this->deltaF);
+  }
+}
+
+#include "../../../include/crystalPlasticity_template_instantiations.h"
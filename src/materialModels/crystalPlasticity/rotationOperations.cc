@@ -50,4 +50,58 @@ void crystalPlasticity<dim>::odfpoint(FullMatrix <double> &OrientationMatrix,Vec
 
 }
 
+//rotation R of the polar decomposition F=RU of a 3x3 matrix, without eigenvectors or a matrix inversion.
+//The eigenvalues of C=F^T*F follow from the trigonometric solution of its characteristic equation, and
+//with the invariants i1,i2,i3 of U=sqrt(C) (Hoger and Carlson, 1984):
+//U=(-C^2+(i1^2-i2)*C+i1*i3*I)/(i1*i2-i3), U^-1=(C-i1*U+i2*I)/i3 and R=F*U^-1
+template <int dim>
+void crystalPlasticity<dim>::polarRotation(const FullMatrix<double> &F, double R[3][3]) {
+
+    double C[3][3], C2[3][3], U[3][3], Uinv[3][3];
+    for(unsigned int i=0;i<3;i++){
+        for(unsigned int j=0;j<3;j++){
+            C[i][j]=F(0,i)*F(0,j)+F(1,i)*F(1,j)+F(2,i)*F(2,j);
+        }
+    }
+    for(unsigned int i=0;i<3;i++){
+        for(unsigned int j=0;j<3;j++){
+            C2[i][j]=C[i][0]*C[0][j]+C[i][1]*C[1][j]+C[i][2]*C[2][j];
+        }
+    }
+
+    //eigenvalues of C: m+2*sqrt(p)*cos(phi+2*k*pi/3) with K=C-m*I, p=|K|^2/6 and cos(3*phi)=det(K)/(2*p^1.5)
+    const double m=(C[0][0]+C[1][1]+C[2][2])/3.0;
+    const double K00=C[0][0]-m, K11=C[1][1]-m, K22=C[2][2]-m;
+    const double p=std::max((K00*K00+K11*K11+K22*K22+2.0*(C[0][1]*C[0][1]+C[0][2]*C[0][2]+C[1][2]*C[1][2]))/6.0,1.0e-200);
+    const double detK=K00*(K11*K22-C[1][2]*C[1][2])-C[0][1]*(C[0][1]*K22-C[1][2]*C[0][2])+C[0][2]*(C[0][1]*C[1][2]-K11*C[0][2]);
+    const double ratio=std::max(-1.0,std::min(1.0,0.5*detK/(p*std::sqrt(p))));
+    const double phi=std::acos(ratio)/3.0;
+    const double sqrtp=std::sqrt(p);
+    const double pi=3.14159265358979323846;
+
+    //principal stretches and invariants of U
+    const double u1=std::sqrt(std::max(m+2.0*sqrtp*std::cos(phi),0.0));
+    const double u2=std::sqrt(std::max(m+2.0*sqrtp*std::cos(phi+2.0*pi/3.0),0.0));
+    const double u3=std::sqrt(std::max(m+2.0*sqrtp*std::cos(phi+4.0*pi/3.0),0.0));
+    const double i1=u1+u2+u3, i2=u1*u2+u2*u3+u3*u1, i3=u1*u2*u3;
+
+    const double D=i1*i2-i3;
+    for(unsigned int i=0;i<3;i++){
+        for(unsigned int j=0;j<3;j++){
+            U[i][j]=(-C2[i][j]+(i1*i1-i2)*C[i][j]+((i==j) ? i1*i3 : 0.0))/D;
+        }
+    }
+    for(unsigned int i=0;i<3;i++){
+        for(unsigned int j=0;j<3;j++){
+            Uinv[i][j]=(C[i][j]-i1*U[i][j]+((i==j) ? i2 : 0.0))/i3;
+        }
+    }
+
+    for(unsigned int i=0;i<3;i++){
+        for(unsigned int j=0;j<3;j++){
+            R[i][j]=F(i,0)*Uinv[0][j]+F(i,1)*Uinv[1][j]+F(i,2)*Uinv[2][j];
+        }
+    }
+}
+
 #include "../../../include/crystalPlasticity_template_instantiations.h"
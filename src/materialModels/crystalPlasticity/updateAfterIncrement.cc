@@ -1,6 +1,21 @@
 #include "../../../include/crystalPlasticity.h"
 #include <iostream>
 #include <fstream>
+#include <map>
+
+namespace {
+	//copy the iteration history of the cells [begin,end) to the converged history
+	template <typename T>
+	void commitHistory(std::vector<T>& conv, const std::vector<T>& iter, unsigned int begin, unsigned int end){
+		for (unsigned int i=begin; (i<end)&&(i<iter.size()); i++){
+			conv[i]=iter[i];
+		}
+	}
+
+	void commitHistory(quadratureHistory& conv, const quadratureHistory& iter, unsigned int begin, unsigned int end){
+		conv.copyCells(iter, begin, end);
+	}
+}
 
 template <int dim>
 void crystalPlasticity<dim>::updateAfterIncrement()
@@ -9,18 +24,54 @@ void crystalPlasticity<dim>::updateAfterIncrement()
 	local_F_s=0.0;
 	local_F_e = 0.0;
 	QGauss<dim>  quadrature(this->userInputs.quadOrder);
-	FEValues<dim> fe_values(this->FE, quadrature, update_quadrature_points | update_gradients | update_JxW_values);
+	FEValues<dim> fe_values(this->getMapping(), this->FE, quadrature, update_quadrature_points | update_gradients | update_JxW_values);
 	const unsigned int num_quad_points = quadrature.size();
 	const unsigned int   dofs_per_cell = this->FE.dofs_per_cell;
 	std::vector<unsigned int> local_dof_indices(dofs_per_cell);
-	//loop over elements
+
+	//////////////////////TabularOutput Start///////////////
+	std::vector<unsigned int> tabularTimeInputIncInt;
+	std::vector<double> tabularTimeInputInc;
+if (this->userInputs.tabularOutput){
+
+	tabularTimeInputInc=this->userInputs.tabularTimeOutput;
+	for(unsigned int i=0;i<this->userInputs.tabularTimeOutput.size();i++){
+	  tabularTimeInputInc[i]=tabularTimeInputInc[i]/this->delT;
+	}
+
+	tabularTimeInputIncInt.resize(this->userInputs.tabularTimeOutput.size(),0);
+	///Converting to an integer always rounds down, even if the fraction part is 0.99999999.
+	//Hence, I add 0.1 to make sure we always get the correct integer.
+	for(unsigned int i=0;i<this->userInputs.tabularTimeOutput.size();i++){
+	  tabularTimeInputIncInt[i]=int(tabularTimeInputInc[i]+0.1);
+	}
+}
+	//////////////////////TabularOutput Finish///////////////
+
+	bool grainAveragedOutputStep=false;
+	if (this->userInputs.writeGrainAveragedOutput){
+		if (((!this->userInputs.tabularOutput)&&((this->currentIncrement+1)%this->userInputs.skipGrainAveragedOutputSteps == 0))||((this->userInputs.tabularOutput)&& (std::count(tabularTimeInputIncInt.begin(), tabularTimeInputIncInt.end(), (this->currentIncrement+1))==1))){
+			grainAveragedOutputStep=true;
+			std::fill(local_grainSums.begin(), local_grainSums.end(), 0.0);
+		}
+	}
+
+	//deformation gradient and JxW of every quadrature point, used by the thread-parallel passes below
+	const unsigned int num_local_cells = this->triangulation.n_locally_owned_active_cells();
+	//(F stored row-wise with dim*dim values per quadrature point)
+	std::vector<double> F_qpts(num_local_cells*num_quad_points*dim*dim);
+	std::vector<double> JxW_qpts(num_local_cells*num_quad_points);
+
+	//loop over elements (serial, calculatePlasticity works on the member variables of the class)
 	unsigned int cellID = 0;
 	typename DoFHandler<dim>::active_cell_iterator cell = this->dofHandler.begin_active(), endc = this->dofHandler.end();
 	for (; cell != endc; ++cell) {
 		if (cell->is_locally_owned()) {
-			fe_values.reinit(cell);
+			//on uniform Cartesian meshes the shape gradients and JxW of the first cell are used for all cells
+			if ((!this->uniformCartesianMesh)||(cellID==0)){
+				fe_values.reinit(cell);
+			}
 			//loop over quadrature points
-			cell->set_user_index(fe_values.get_cell()->user_index());
 			cell->get_dof_indices(local_dof_indices);
 
 			Vector<double> Ulocal(dofs_per_cell);
@@ -43,30 +94,14 @@ void crystalPlasticity<dim>::updateAfterIncrement()
 				//Update strain, stress, and tangent for current time step/quadrature point
 				calculatePlasticity(cellID, q, 0);
 
-				FullMatrix<double> temp,temp3,temp4, C_tau(dim, dim), E_tau(dim, dim), b_tau(dim, dim);
-				Vector<double> temp2;
-				temp.reinit(dim, dim); temp = 0.0;
-				temp2.reinit(dim); temp2 = 0.0;
-				temp3.reinit(dim, dim); temp3 = 0.0;
-				temp4.reinit(dim, dim); temp4 = 0.0;
-				C_tau = 0.0;
-				temp = F;
-				F.Tmmult(C_tau, temp);
-				F.mTmult(b_tau, temp);
-				//E_tau = CE_tau;
-				temp = IdentityMatrix(dim);
-				for (unsigned int i = 0;i<dim;i++) {
-					temp2[i] = 0.5*log(b_tau[i][i])*fe_values.JxW(q);
-					for (unsigned int j = 0;j<dim;j++) {
-						E_tau[i][j] = 0.5*(C_tau[i][j] - temp[i][j]);
-						temp3[i][j] = T[i][j] * fe_values.JxW(q);
-						temp4[i][j] = E_tau[i][j]*fe_values.JxW(q);
+				for (unsigned int i = 0; i < dim; ++i) {
+					for (unsigned int j = 0; j < dim; ++j) {
+						F_qpts[((cellID*num_quad_points+q)*dim+i)*dim+j]=F[i][j];
 					}
 				}
-
+				JxW_qpts[cellID*num_quad_points+q]=fe_values.JxW(q);
 				CauchyStress[cellID][q]=T;
 
-
 				if (this->userInputs.enableAdvRateDepModel){
 					for(unsigned int i=0; i<dim ; i++){
 						for(unsigned int j=0 ; j<dim ; j++){
@@ -75,79 +110,164 @@ void crystalPlasticity<dim>::updateAfterIncrement()
 						}
 					}
 				}
+			}
+			cellID++;
+		}
+	}
 
-				local_strain.add(1.0, temp4);
-				local_stress.add(1.0, temp3);
-				local_microvol = local_microvol + fe_values.JxW(q);
+	//averaging and post processing values, done by the threads over fixed chunks of the cells.
+	//Each chunk sums into its own variables, which are added to the process sums in the order of
+	//the chunks after the loop, so the sums do not depend on the scheduling of the threads.
+	//The per-grain sums of a chunk are only stored for the grains of its cells.
+	const unsigned int chunkSize=this->getThreadGrainSize(num_local_cells);
+	const unsigned int numChunks=(num_local_cells+chunkSize-1)/chunkSize;
+	struct chunkSums{
+		FullMatrix<double> strain, stress;
+		double microvol, F_r, F_s, F_e;
+		std::map<unsigned int, std::vector<double> > grainSums;
+	};
+	std::vector<chunkSums> chunks(numChunks);
+	auto grainSumsOf=[&](chunkSums &sums, const unsigned int grainID){
+		std::vector<double> &g=sums.grainSums[grainID];
+		if (g.empty()) g.assign(numGrainAveragedFields, 0.0);
+		return &g[0];
+	};
+	auto mergeGrainSums=[&](){
+		for (unsigned int chunk=0; chunk<numChunks; chunk++){
+			for (const auto &grain : chunks[chunk].grainSums){
+				double *g=&local_grainSums[grain.first*numGrainAveragedFields];
+				for (unsigned int i=0; i<numGrainAveragedFields; i++){
+					g[i]+=grain.second[i];
+				}
+			}
+			chunks[chunk].grainSums.clear();
+		}
+	};
+	auto sumCells=[&](const unsigned int begin, const unsigned int end, chunkSums &sums){
+			sums.strain.reinit(dim, dim); sums.stress.reinit(dim, dim);
+			sums.microvol=0.0; sums.F_r=0.0; sums.F_s=0.0; sums.F_e=0.0;
+			sums.grainSums.clear();
+			FullMatrix<double> &subrange_strain=sums.strain, &subrange_stress=sums.stress;
+			double &subrange_microvol=sums.microvol, &subrange_F_r=sums.F_r, &subrange_F_s=sums.F_s, &subrange_F_e=sums.F_e;
+
+			FullMatrix<double> F_tau(dim, dim), T_tau(dim, dim), temp(dim, dim), C_tau(dim, dim), E_tau(dim, dim), b_tau(dim, dim);
+			FullMatrix<double> deve(dim, dim), devt(dim, dim);
+			for (unsigned int cellID=begin; cellID<end; cellID++){
+				for (unsigned int q = 0; q < num_quad_points; ++q) {
+					for (unsigned int i = 0; i < dim; ++i) {
+						for (unsigned int j = 0; j < dim; ++j) {
+							F_tau[i][j] = F_qpts[((cellID*num_quad_points+q)*dim+i)*dim+j];
+						}
+					}
+					T_tau = CauchyStress[cellID][q];
+					const double JxW = JxW_qpts[cellID*num_quad_points+q];
+
+					temp = F_tau;
+					F_tau.Tmmult(C_tau, temp);
+					F_tau.mTmult(b_tau, temp);
+					//E_tau = CE_tau;
+					temp = IdentityMatrix(dim);
+					for (unsigned int i = 0;i<dim;i++) {
+						for (unsigned int j = 0;j<dim;j++) {
+							E_tau[i][j] = 0.5*(C_tau[i][j] - temp[i][j]);
+						}
+					}
 
-				//calculate von-Mises stress and equivalent strain
-				double traceE, traceT, vonmises, eqvstrain;
-				FullMatrix<double> deve(dim, dim), devt(dim, dim);
+					subrange_strain.add(JxW, E_tau);
+					subrange_stress.add(JxW, T_tau);
+					subrange_microvol = subrange_microvol + JxW;
 
+					//calculate von-Mises stress and equivalent strain
+					double traceE, traceT, vonmises, eqvstrain;
 
-				traceE = E_tau.trace();
-				traceT = T.trace();
-				temp = IdentityMatrix(3);
-				temp.equ(traceE / 3, temp);
+					traceE = E_tau.trace();
+					traceT = T_tau.trace();
+					temp = IdentityMatrix(3);
+					temp.equ(traceE / 3, temp);
 
-				deve = E_tau;
-				deve.add(-1.0, temp);
+					deve = E_tau;
+					deve.add(-1.0, temp);
 
-				temp = IdentityMatrix(3);
-				temp.equ(traceT / 3, temp);
+					temp = IdentityMatrix(3);
+					temp.equ(traceT / 3, temp);
 
-				devt = T;
-				devt.add(-1.0, temp);
+					devt = T_tau;
+					devt.add(-1.0, temp);
 
-				vonmises = devt.frobenius_norm();
-				vonmises = sqrt(3.0 / 2.0)*vonmises;
-				eqvstrain = deve.frobenius_norm();
-				eqvstrain = sqrt(2.0 / 3.0)*eqvstrain;
+					vonmises = devt.frobenius_norm();
+					vonmises = sqrt(3.0 / 2.0)*vonmises;
+					eqvstrain = deve.frobenius_norm();
+					eqvstrain = sqrt(2.0 / 3.0)*eqvstrain;
 
-				//fill in post processing field values
-				if (!this->userInputs.enableAdvancedTwinModel){
-					twin_ouput[cellID][q]=twin_iter[cellID][q];
-				}
-				else{
-					if (TotaltwinvfK[cellID][q]>=this->userInputs.criteriaTwinVisual){
-						twin_ouput[cellID][q]=1;
+					//fill in post processing field values
+					if (!this->userInputs.enableAdvancedTwinModel){
+						twin_ouput[cellID][q]=twin_iter[cellID][q];
 					}
 					else{
-						twin_ouput[cellID][q]=0;
+						if (TotaltwinvfK[cellID][q]>=this->userInputs.criteriaTwinVisual){
+							twin_ouput[cellID][q]=1;
+						}
+						else{
+							twin_ouput[cellID][q]=0;
+						}
+					}
+					if (this->userInputs.writeOutput){
+						this->postprocessValues(cellID, q, 0, 0) = vonmises;
+						this->postprocessValues(cellID, q, 1, 0) = eqvstrain;
+						this->postprocessValues(cellID, q, 2, 0) = twin_ouput[cellID][q];
 					}
-				}
-				if (this->userInputs.writeOutput){
-					this->postprocessValues(cellID, q, 0, 0) = vonmises;
-					this->postprocessValues(cellID, q, 1, 0) = eqvstrain;
-					this->postprocessValues(cellID, q, 2, 0) = twin_ouput[cellID][q];
-				}
 
+					for(unsigned int i=0;i<this->userInputs.numTwinSystems1;i++){
+						subrange_F_r=subrange_F_r+twinfraction_iter(cellID,q,i)*JxW;
+					}
 
+					if (!this->userInputs.enableAdvancedTwinModel){
+						subrange_F_e = subrange_F_e + twin_ouput[cellID][q] * JxW;
+					}
+					else{
+						subrange_F_e=subrange_F_e+ TotaltwinvfK[cellID][q]*JxW;
+					}
 
-				for(unsigned int i=0;i<this->userInputs.numTwinSystems1;i++){
-					local_F_r=local_F_r+twinfraction_iter[cellID][q][i]*fe_values.JxW(q);
-				}
+					for(unsigned int i=0;i<this->userInputs.numSlipSystems1;i++){
+						subrange_F_s=subrange_F_s+slipfraction_iter[cellID][q][i]*JxW;
+					}
 
-				if (!this->userInputs.enableAdvancedTwinModel){
-					local_F_e = local_F_e + twin_ouput[cellID][q] * fe_values.JxW(q);
-				}
-				else{
-					local_F_e=local_F_e+ TotaltwinvfK[cellID][q]*fe_values.JxW(q);
+					if (grainAveragedOutputStep){
+						//volume weighted sums per grain, orientation is added after reorient()
+						double *g=grainSumsOf(sums, cellOrientationMap[cellID]);
+						g[0]+=JxW;
+						g[1]+=T_tau[0][0]*JxW; g[2]+=T_tau[1][1]*JxW; g[3]+=T_tau[2][2]*JxW;
+						g[4]+=T_tau[1][2]*JxW; g[5]+=T_tau[0][2]*JxW; g[6]+=T_tau[0][1]*JxW;
+						g[7]+=E_tau[0][0]*JxW; g[8]+=E_tau[1][1]*JxW; g[9]+=E_tau[2][2]*JxW;
+						g[10]+=E_tau[1][2]*JxW; g[11]+=E_tau[0][2]*JxW; g[12]+=E_tau[0][1]*JxW;
+						for(unsigned int i=0;i<slipfraction_iter[cellID][q].size();i++){
+							g[13]+=slipfraction_iter[cellID][q][i]*JxW;
+						}
+						for(unsigned int i=0;i<twinfraction_iter.n_components();i++){
+							g[14]+=twinfraction_iter(cellID,q,i)*JxW;
+						}
+					}
 				}
-
-
-				for(unsigned int i=0;i<this->userInputs.numSlipSystems1;i++){
-					local_F_s=local_F_s+slipfraction_iter[cellID][q][i]*fe_values.JxW(q);
+				if (this->userInputs.writeOutput){
+					this->postprocessValuesAtCellCenters(cellID,0)=cellOrientationMap[cellID];
 				}
-
 			}
-			if (this->userInputs.writeOutput){
-				this->postprocessValuesAtCellCenters(cellID,0)=cellOrientationMap[cellID];
+		};
+	parallel::apply_to_subranges(0u, numChunks,
+		[&](const unsigned int beginChunk, const unsigned int endChunk){
+			for (unsigned int chunk=beginChunk; chunk<endChunk; chunk++){
+				sumCells(chunk*chunkSize, std::min(num_local_cells, (chunk+1)*chunkSize), chunks[chunk]);
 			}
-
-			cellID++;
-		}
+		}, 1);
+	for (unsigned int chunk=0; chunk<numChunks; chunk++){
+		local_strain.add(1.0, chunks[chunk].strain);
+		local_stress.add(1.0, chunks[chunk].stress);
+		local_microvol = local_microvol + chunks[chunk].microvol;
+		local_F_r = local_F_r + chunks[chunk].F_r;
+		local_F_s = local_F_s + chunks[chunk].F_s;
+		local_F_e = local_F_e + chunks[chunk].F_e;
 	}
+	mergeGrainSums();
 
 	//In Case we have twinning
 	rotnew_conv=rotnew_iter;
@@ -160,52 +280,61 @@ void crystalPlasticity<dim>::updateAfterIncrement()
 	//Updating rotnew_iter using rotnew_conv updated by reorient();
 	rotnew_iter=rotnew_conv;
 
-	//Update the history variables when convergence is reached for the current increment
-	Fe_conv=Fe_iter;
-	Fp_conv=Fp_iter;
-	s_alpha_conv=s_alpha_iter;
-	W_kh_conv = W_kh_iter;
-	twinfraction_conv=twinfraction_iter;
-	slipfraction_conv=slipfraction_iter;
-	rot_conv=rot_iter;
-	twin_conv=twin_iter;
-
-	if (this->userInputs.enableUserMaterialModel){
-		stateVar_conv=stateVar_iter;
-	}
-
-	if (this->userInputs.enableAdvancedTwinModel){
-		TwinMaxFlag_conv = TwinMaxFlag_iter;
-		NumberOfTwinnedRegion_conv = NumberOfTwinnedRegion_iter;
-		ActiveTwinSystems_conv = ActiveTwinSystems_iter;
-		TwinFlag_conv = TwinFlag_iter;
-		TwinOutputfraction_conv=TwinOutputfraction_iter;
+	if (grainAveragedOutputStep){
+		//volume weighted orientation sums, over the same chunks and merged in the same order
+		parallel::apply_to_subranges(0u, numChunks,
+			[&](const unsigned int beginChunk, const unsigned int endChunk){
+				Vector<double> quat(4), rod(dim);
+				for (unsigned int chunk=beginChunk; chunk<endChunk; chunk++){
+					const unsigned int end=std::min(num_local_cells, (chunk+1)*chunkSize);
+					for (unsigned int i=chunk*chunkSize; i<end; ++i) {
+						double *g=grainSumsOf(chunks[chunk], cellOrientationMap[i]);
+						for(unsigned int j=0;j<num_quad_points;j++){
+							rotnew_conv.get(i,j,rod);
+							rod2quat(quat,rod);
+							for(unsigned int k=0;k<4;k++){
+								g[15+k]+=quat(k)*JxW_qpts[i*num_quad_points+j];
+							}
+						}
+					}
+				}
+			}, 1);
+		mergeGrainSums();
+		writeGrainAveragedOutput(this->userInputs.outputDirectory, this->currentIncrement);
 	}
 
+	//Update the history variables when convergence is reached for the current increment
+	//(the cells are independent and copied by the threads over subranges of the cells)
+	parallel::apply_to_subranges(0u, num_local_cells,
+		[&](const unsigned int begin, const unsigned int end){
+			commitHistory(Fe_conv, Fe_iter, begin, end);
+			commitHistory(Fp_conv, Fp_iter, begin, end);
+			commitHistory(s_alpha_conv, s_alpha_iter, begin, end);
+			commitHistory(W_kh_conv, W_kh_iter, begin, end);
+			commitHistory(twinfraction_conv, twinfraction_iter, begin, end);
+			commitHistory(slipfraction_conv, slipfraction_iter, begin, end);
+			commitHistory(rot_conv, rot_iter, begin, end);
+			commitHistory(twin_conv, twin_iter, begin, end);
+
+			if (this->userInputs.enableUserMaterialModel){
+				commitHistory(stateVar_conv, stateVar_iter, begin, end);
+			}
 
+			if (this->userInputs.enableAdvancedTwinModel){
+				commitHistory(TwinMaxFlag_conv, TwinMaxFlag_iter, begin, end);
+				commitHistory(NumberOfTwinnedRegion_conv, NumberOfTwinnedRegion_iter, begin, end);
+				commitHistory(ActiveTwinSystems_conv, ActiveTwinSystems_iter, begin, end);
+				commitHistory(TwinFlag_conv, TwinFlag_iter, begin, end);
+				commitHistory(TwinOutputfraction_conv, TwinOutputfraction_iter, begin, end);
+			}
+		}, this->getThreadGrainSize(num_local_cells));
 
 
 
-	char buffer[200];
 
-	//////////////////////TabularOutput Start///////////////
-	std::vector<unsigned int> tabularTimeInputIncInt;
-	std::vector<double> tabularTimeInputInc;
-if (this->userInputs.tabularOutput){
 
-	tabularTimeInputInc=this->userInputs.tabularTimeOutput;
-	for(unsigned int i=0;i<this->userInputs.tabularTimeOutput.size();i++){
-	  tabularTimeInputInc[i]=tabularTimeInputInc[i]/this->delT;
-	}
+	char buffer[200];
 
-	tabularTimeInputIncInt.resize(this->userInputs.tabularTimeOutput.size(),0);
-	///Converting to an integer always rounds down, even if the fraction part is 0.99999999.
-	//Hence, I add 0.1 to make sure we always get the correct integer.
-	for(unsigned int i=0;i<this->userInputs.tabularTimeOutput.size();i++){
-	  tabularTimeInputIncInt[i]=int(tabularTimeInputInc[i]+0.1);
-	}
-}
-	//////////////////////TabularOutput Finish///////////////
 	if (this->userInputs.writeQuadratureOutput) {
 		if (((!this->userInputs.tabularOutput)&&((this->currentIncrement+1)%this->userInputs.skipQuadratureOutputSteps == 0))||((this->userInputs.tabularOutput)&& (std::count(tabularTimeInputIncInt.begin(), tabularTimeInputIncInt.end(), (this->currentIncrement+1))==1))){
 			//copy rotnew to output
@@ -233,9 +362,9 @@ if (this->userInputs.tabularOutput){
 						temp.push_back(fe_values.get_quadrature_points()[q][1]);
 						temp.push_back(fe_values.get_quadrature_points()[q][2]);
 
-						temp.push_back(rotnew_conv[cellID][q][0]);
-						temp.push_back(rotnew_conv[cellID][q][1]);
-						temp.push_back(rotnew_conv[cellID][q][2]);
+						temp.push_back(rotnew_conv(cellID,q,0));
+						temp.push_back(rotnew_conv(cellID,q,1));
+						temp.push_back(rotnew_conv(cellID,q,2));
 
 						temp.push_back(Fe_conv[cellID][q][0][0]);
 						temp.push_back(Fe_conv[cellID][q][1][1]);
@@ -375,12 +504,12 @@ if (this->userInputs.tabularOutput){
 						temp.push_back(slipfraction_conv[cellID][q][83]);
 
 
-						temp.push_back(twinfraction_conv[cellID][q][0]);
-						temp.push_back(twinfraction_conv[cellID][q][1]);
-						temp.push_back(twinfraction_conv[cellID][q][2]);
-						temp.push_back(twinfraction_conv[cellID][q][3]);
-						temp.push_back(twinfraction_conv[cellID][q][4]);
-						temp.push_back(twinfraction_conv[cellID][q][5]);
+						temp.push_back(twinfraction_conv(cellID,q,0));
+						temp.push_back(twinfraction_conv(cellID,q,1));
+						temp.push_back(twinfraction_conv(cellID,q,2));
+						temp.push_back(twinfraction_conv(cellID,q,3));
+						temp.push_back(twinfraction_conv(cellID,q,4));
+						temp.push_back(twinfraction_conv(cellID,q,5));
 
 						if (this->userInputs.enableAdvancedTwinModel){
 							temp.push_back(TwinOutputfraction_conv[cellID][q][0]);
@@ -410,57 +539,57 @@ if (this->userInputs.tabularOutput){
 						}
 
 						if (this->userInputs.enableUserMaterialModel){
-							temp.push_back(stateVar_conv[cellID][q][0]);
-							temp.push_back(stateVar_conv[cellID][q][1]);
-							temp.push_back(stateVar_conv[cellID][q][2]);
-							temp.push_back(stateVar_conv[cellID][q][3]);
-							temp.push_back(stateVar_conv[cellID][q][4]);
-							temp.push_back(stateVar_conv[cellID][q][5]);
-							temp.push_back(stateVar_conv[cellID][q][6]);
-							temp.push_back(stateVar_conv[cellID][q][7]);
-							temp.push_back(stateVar_conv[cellID][q][8]);
-							temp.push_back(stateVar_conv[cellID][q][9]);
-							temp.push_back(stateVar_conv[cellID][q][10]);
-							temp.push_back(stateVar_conv[cellID][q][11]);
-							temp.push_back(stateVar_conv[cellID][q][12]);
-							temp.push_back(stateVar_conv[cellID][q][13]);
-							temp.push_back(stateVar_conv[cellID][q][14]);
-							temp.push_back(stateVar_conv[cellID][q][15]);
-							temp.push_back(stateVar_conv[cellID][q][16]);
-							temp.push_back(stateVar_conv[cellID][q][17]);
-							temp.push_back(stateVar_conv[cellID][q][18]);
-							temp.push_back(stateVar_conv[cellID][q][19]);
-							temp.push_back(stateVar_conv[cellID][q][20]);
-							temp.push_back(stateVar_conv[cellID][q][21]);
-							temp.push_back(stateVar_conv[cellID][q][22]);
-							temp.push_back(stateVar_conv[cellID][q][23]);
-							temp.push_back(stateVar_conv[cellID][q][24]);
-							temp.push_back(stateVar_conv[cellID][q][25]);
-							temp.push_back(stateVar_conv[cellID][q][26]);
-							temp.push_back(stateVar_conv[cellID][q][27]);
-							temp.push_back(stateVar_conv[cellID][q][28]);
-							temp.push_back(stateVar_conv[cellID][q][29]);
-							temp.push_back(stateVar_conv[cellID][q][30]);
-							temp.push_back(stateVar_conv[cellID][q][31]);
-							temp.push_back(stateVar_conv[cellID][q][32]);
-							temp.push_back(stateVar_conv[cellID][q][33]);
-							temp.push_back(stateVar_conv[cellID][q][34]);
-							temp.push_back(stateVar_conv[cellID][q][35]);
-							temp.push_back(stateVar_conv[cellID][q][36]);
-							temp.push_back(stateVar_conv[cellID][q][37]);
-							temp.push_back(stateVar_conv[cellID][q][38]);
-							temp.push_back(stateVar_conv[cellID][q][39]);
-							temp.push_back(stateVar_conv[cellID][q][40]);
-							temp.push_back(stateVar_conv[cellID][q][41]);
-							temp.push_back(stateVar_conv[cellID][q][42]);
-							temp.push_back(stateVar_conv[cellID][q][43]);
-							temp.push_back(stateVar_conv[cellID][q][44]);
-							temp.push_back(stateVar_conv[cellID][q][45]);
-							temp.push_back(stateVar_conv[cellID][q][46]);
-							temp.push_back(stateVar_conv[cellID][q][47]);
-							temp.push_back(stateVar_conv[cellID][q][48]);
-							temp.push_back(stateVar_conv[cellID][q][49]);
-							temp.push_back(stateVar_conv[cellID][q][50]);
+							temp.push_back(stateVar_conv(cellID,q,0));
+							temp.push_back(stateVar_conv(cellID,q,1));
+							temp.push_back(stateVar_conv(cellID,q,2));
+							temp.push_back(stateVar_conv(cellID,q,3));
+							temp.push_back(stateVar_conv(cellID,q,4));
+							temp.push_back(stateVar_conv(cellID,q,5));
+							temp.push_back(stateVar_conv(cellID,q,6));
+							temp.push_back(stateVar_conv(cellID,q,7));
+							temp.push_back(stateVar_conv(cellID,q,8));
+							temp.push_back(stateVar_conv(cellID,q,9));
+							temp.push_back(stateVar_conv(cellID,q,10));
+							temp.push_back(stateVar_conv(cellID,q,11));
+							temp.push_back(stateVar_conv(cellID,q,12));
+							temp.push_back(stateVar_conv(cellID,q,13));
+							temp.push_back(stateVar_conv(cellID,q,14));
+							temp.push_back(stateVar_conv(cellID,q,15));
+							temp.push_back(stateVar_conv(cellID,q,16));
+							temp.push_back(stateVar_conv(cellID,q,17));
+							temp.push_back(stateVar_conv(cellID,q,18));
+							temp.push_back(stateVar_conv(cellID,q,19));
+							temp.push_back(stateVar_conv(cellID,q,20));
+							temp.push_back(stateVar_conv(cellID,q,21));
+							temp.push_back(stateVar_conv(cellID,q,22));
+							temp.push_back(stateVar_conv(cellID,q,23));
+							temp.push_back(stateVar_conv(cellID,q,24));
+							temp.push_back(stateVar_conv(cellID,q,25));
+							temp.push_back(stateVar_conv(cellID,q,26));
+							temp.push_back(stateVar_conv(cellID,q,27));
+							temp.push_back(stateVar_conv(cellID,q,28));
+							temp.push_back(stateVar_conv(cellID,q,29));
+							temp.push_back(stateVar_conv(cellID,q,30));
+							temp.push_back(stateVar_conv(cellID,q,31));
+							temp.push_back(stateVar_conv(cellID,q,32));
+							temp.push_back(stateVar_conv(cellID,q,33));
+							temp.push_back(stateVar_conv(cellID,q,34));
+							temp.push_back(stateVar_conv(cellID,q,35));
+							temp.push_back(stateVar_conv(cellID,q,36));
+							temp.push_back(stateVar_conv(cellID,q,37));
+							temp.push_back(stateVar_conv(cellID,q,38));
+							temp.push_back(stateVar_conv(cellID,q,39));
+							temp.push_back(stateVar_conv(cellID,q,40));
+							temp.push_back(stateVar_conv(cellID,q,41));
+							temp.push_back(stateVar_conv(cellID,q,42));
+							temp.push_back(stateVar_conv(cellID,q,43));
+							temp.push_back(stateVar_conv(cellID,q,44));
+							temp.push_back(stateVar_conv(cellID,q,45));
+							temp.push_back(stateVar_conv(cellID,q,46));
+							temp.push_back(stateVar_conv(cellID,q,47));
+							temp.push_back(stateVar_conv(cellID,q,48));
+							temp.push_back(stateVar_conv(cellID,q,49));
+							temp.push_back(stateVar_conv(cellID,q,50));
 						}
 
 						addToQuadratureOutput(temp);
@@ -0,0 +1,71 @@
+#include "../../../include/crystalPlasticity.h"
+
+template <int dim>
+void crystalPlasticity<dim>::initGrainAveragedOutput()
+{
+	//volume, stress (6), strain (6), total slip, twin fraction, quaternion (4)
+	numGrainAveragedFields=19;
+
+	//grain IDs are used directly as row indices, so the table spans the largest grain ID on any processor
+	unsigned int maxGrainID=0;
+	for (unsigned int i=0; i<cellOrientationMap.size(); i++){
+		if (cellOrientationMap[i]>maxGrainID)
+		maxGrainID=cellOrientationMap[i];
+	}
+	n_grains=Utilities::MPI::max(maxGrainID,this->mpi_communicator)+1;
+
+	local_grainSums.resize(n_grains*numGrainAveragedFields,0.0);
+	global_grainSums.resize(n_grains*numGrainAveragedFields,0.0);
+}
+
+template <int dim>
+void crystalPlasticity<dim>::writeGrainAveragedOutput(std::string _outputDirectory, unsigned int _currentIncrement)
+{
+	//single reduction of the whole per-grain table
+	Utilities::MPI::sum(local_grainSums,this->mpi_communicator,global_grainSums);
+
+	if (Utilities::MPI::this_mpi_process(this->mpi_communicator)==0){
+		this->pcout << "writing grain averaged data to file\n";
+		std::string dir(_outputDirectory);
+		if (_outputDirectory.back() != '/') dir += "/";
+
+		std::string fileName("GrainAveragedOutputs");
+		std::string fileExtension(".csv");
+		std::ofstream file((dir + fileName + std::to_string(_currentIncrement)+fileExtension).c_str());
+		char buffer[200];
+		if (file.is_open()) {
+			file << "GrainID,Volume,Txx,Tyy,Tzz,Tyz,Txz,Txy,Exx,Eyy,Ezz,Eyz,Exz,Exy,SlipTotal,TwinRealVF,r1,r2,r3\n";
+			Vector<double> quat(4),rod(3);
+			for (unsigned int grain=0; grain<n_grains; grain++){
+				const double *g=&global_grainSums[grain*numGrainAveragedFields];
+				const double volume=g[0];
+				//grain IDs that do not occur in the mesh are not written
+				if (volume<=0.0)
+				continue;
+
+				sprintf(buffer, "%u,%8.5e", grain, volume);
+				file << buffer;
+				for (unsigned int i=1; i<15; i++){
+					sprintf(buffer, ",%8.5e", g[i]/volume);
+					file << buffer;
+				}
+
+				//mean orientation from the normalized volume averaged quaternion (no crystal symmetry reduction)
+				double quatNorm=sqrt(g[15]*g[15]+g[16]*g[16]+g[17]*g[17]+g[18]*g[18]);
+				for (unsigned int i=0; i<4; i++){
+					quat(i)=g[15+i]/quatNorm;
+				}
+				quat2rod(quat,rod);
+				sprintf(buffer, ",%8.5e,%8.5e,%8.5e\n", rod(0), rod(1), rod(2));
+				file << buffer;
+			}
+			file.close();
+		}
+		else {
+			this->pcout << "Unable to open file for writing grain averaged outputs\n";
+			exit(1);
+		}
+	}
+}
+
+#include "../../../include/crystalPlasticity_template_instantiations.h"
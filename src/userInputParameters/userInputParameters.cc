@@ -41,6 +41,8 @@ pcout (std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0)
 
   //External mesh parameters
   readExternalMesh = parameter_handler.get_bool("Use external mesh");
+  voxelAlignedMesh = parameter_handler.get_bool("Voxel aligned mesh");
+  grainInteriorCoarseningLevels = parameter_handler.get_integer("Grain interior coarsening levels");
   externalMeshFileName = parameter_handler.get("Name of file containing external mesh");
   externalMeshParameter = parameter_handler.get_double("External mesh parameter");
 
@@ -54,10 +56,18 @@ pcout (std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0)
   skipOutputSteps=parameter_handler.get_integer("Skip Output Steps");
   writeQuadratureOutput = parameter_handler.get_bool("Write Quadrature Output");
   skipQuadratureOutputSteps=parameter_handler.get_integer("Skip Quadrature Output Steps");
+  writeGrainAveragedOutput = parameter_handler.get_bool("Write Grain Averaged Output");
+  writeMemoryReportPerIncrement = parameter_handler.get_bool("Write memory report per increment");
+  int skipGrainSteps=parameter_handler.get_integer("Skip Grain Averaged Output Steps");
 
   if(skipOutputSteps<=0)
   skipOutputSteps=1;
 
+  if(skipGrainSteps<=0)
+  skipGrainAveragedOutputSteps=1;
+  else
+  skipGrainAveragedOutputSteps=skipGrainSteps;
+
   delT=parameter_handler.get_double("Time increments");
   totalTime=parameter_handler.get_double("Total time");
 
@@ -89,6 +99,7 @@ pcout (std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0)
   DIC_BCfilename2=parameter_handler.get("DIC Boundary condition filename 2");
   DIC_BCfilename3=parameter_handler.get("DIC Boundary condition filename 3");
   DIC_BCfilename4=parameter_handler.get("DIC Boundary condition filename 4");
+  enableDICLinearInterpolation=parameter_handler.get_bool("Use DIC linear interpolation");
 
   enableCyclicLoading=parameter_handler.get_bool("Enable cyclic loading");
   cyclicLoadingFace=parameter_handler.get_integer("Cyclic loading face");
@@ -118,11 +129,29 @@ pcout (std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0)
   absNonLinearTolerance=parameter_handler.get_double("Absolute nonLinear solver tolerance");
   relNonLinearTolerance=parameter_handler.get_double("Relative nonLinear solver tolerance");
   stopOnConvergenceFailure = parameter_handler.get_bool("Stop on convergence failure");
+  enableNonLinearConvergenceCheck = parameter_handler.get_bool("Enable nonlinear convergence check");
   enableAdaptiveTimeStepping = parameter_handler.get_bool("Enable adaptive Time stepping");
   adaptiveLoadStepFactor=parameter_handler.get_double("Adaptive load step factor");
   adaptiveLoadIncreaseFactor=parameter_handler.get_double("Adaptive load increase Factor");
   succesiveIncForIncreasingTimeStep=parameter_handler.get_double("Succesive increment for increasing time step");
+  maxIncrementCutbacks=parameter_handler.get_integer("Maximum number of increment cutbacks");
+  enableCostWeightedRepartition = parameter_handler.get_bool("Enable cost weighted repartitioning");
+  repartitionInterval=parameter_handler.get_integer("Repartition interval");
+  if (repartitionInterval==0) repartitionInterval=1;
+  numThreadsPerProcess=parameter_handler.get_integer("Number of threads per process");
+  if (numThreadsPerProcess==0) numThreadsPerProcess=1;
+  enableAdaptiveRefinement = parameter_handler.get_bool("Enable adaptive refinement");
+  adaptiveRefinementInterval=parameter_handler.get_integer("Adaptive refinement interval");
+  if (adaptiveRefinementInterval==0) adaptiveRefinementInterval=1;
+  adaptiveRefinementIndicator = parameter_handler.get("Adaptive refinement indicator");
+  adaptiveRefineFraction=parameter_handler.get_double("Adaptive refinement fraction");
+  adaptiveCoarsenFraction=parameter_handler.get_double("Adaptive coarsening fraction");
+  maxAdaptiveRefinementLevels=parameter_handler.get_integer("Max adaptive refinement levels");
   enableStiffnessFirstIter = parameter_handler.get_bool("Enable the efficient calculation of stiffness");
+  enableExtrapolationPredictor = parameter_handler.get_bool("Enable extrapolation predictor");
+  enableInexactLocalTolerance = parameter_handler.get_bool("Enable inexact local tolerance");
+  maxLocalToleranceFactor = parameter_handler.get_double("Maximum local tolerance factor");
+  if (maxLocalToleranceFactor<1.0) maxLocalToleranceFactor=1.0;
 
 
 
@@ -206,8 +235,11 @@ pcout (std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0)
 
   modelStressTolerance=parameter_handler.get_double("Stress Tolerance");
   modelMaxSlipSearchIterations=parameter_handler.get_integer("Max Slip Search Iterations");
+  modelMaxSubsteps=parameter_handler.get_integer("Max Material Point Substeps");
+  enableSlipWarmStart=parameter_handler.get_bool("Enable slip warm start");
   modelMaxSolverIterations=parameter_handler.get_integer("Max Solver Iterations");
   modelMaxPlasticSlipL2Norm=parameter_handler.get_double("Max Plastic Slip L2 Norm");
+  singlePrecisionHistoryFields=dealii::Utilities::split_string_list(parameter_handler.get("Single precision history fields"));
 
   grainIDFile = parameter_handler.get("Grain ID file name");
   numPts.push_back(parameter_handler.get_double("Voxels in X direction"));
@@ -218,6 +250,26 @@ pcout (std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0)
     }
   }
 
+  //the coarse mesh of the voxel aligned mesh has one cell per voxel, each refinement splits a voxel in 2^dim elements.
+  //With grain interior coarsening, a coarse cell covers 2^grainInteriorCoarseningLevels voxels in each direction
+  //and is refined down to the voxels only where it covers more than one grain.
+  if (voxelAlignedMesh&&!readExternalMesh){
+    if (enablePeriodicBCs&&(grainInteriorCoarseningLevels>0)){
+      pcout<<"Grain interior coarsening is not supported with periodic BCs, using the uniform voxel aligned mesh\n";
+      grainInteriorCoarseningLevels=0;
+    }
+    for (unsigned int i=0; i<dim; i++){
+      if (numPts[i]%(1<<grainInteriorCoarseningLevels)!=0){
+        pcout<<"The number of voxels in each direction must be divisible by 2^(Grain interior coarsening levels)\n";
+        exit(1);
+      }
+      subdivisions[i]=numPts[i]>>grainInteriorCoarseningLevels;
+    }
+  }
+  else{
+    grainInteriorCoarseningLevels=0;
+  }
+
   grainOrientationsFile = parameter_handler.get("Orientations file name");
   headerLinesGrainIDFile=parameter_handler.get_integer("Header Lines GrainID File");
 
@@ -443,6 +495,8 @@ void userInputParameters::declare_parameters(dealii::ParameterHandler & paramete
   parameter_handler.declare_entry("Write Mesh To EPS","false",dealii::Patterns::Bool(),"Only written for serial runs and if number of elements < 10000");
 
   parameter_handler.declare_entry("Use external mesh","false",dealii::Patterns::Bool(),"Flag to indicate whether to use external mesh");
+  parameter_handler.declare_entry("Grain interior coarsening levels","0",dealii::Patterns::Integer(),"Number of octree levels by which voxels inside a grain are merged in the voxel aligned mesh (the mesh is refined down to the voxels near grain boundaries)");
+  parameter_handler.declare_entry("Voxel aligned mesh","false",dealii::Patterns::Bool(),"Flag to generate the coarse mesh with one cell per voxel of the grain ID file (overrides the subdivisions), with the grain IDs stored as material IDs");
   parameter_handler.declare_entry("Name of file containing external mesh","",dealii::Patterns::Anything(),"Name of external mesh file");
   parameter_handler.declare_entry("External mesh parameter","0",dealii::Patterns::Double(),"The external mesh parameter: The ratio of defiend region size to the Domain size");
 
@@ -475,6 +529,7 @@ void userInputParameters::declare_parameters(dealii::ParameterHandler & paramete
   parameter_handler.declare_entry("DIC Boundary condition filename 2","DICboundaryConditions2.txt",dealii::Patterns::Anything(),"DIC Boundary condition filename 2 (x == spanX)");
   parameter_handler.declare_entry("DIC Boundary condition filename 3","DICboundaryConditions3.txt",dealii::Patterns::Anything(),"DIC Boundary condition filename 3 (y == 0.0)");
   parameter_handler.declare_entry("DIC Boundary condition filename 4","DICboundaryConditions4.txt",dealii::Patterns::Anything(),"DIC Boundary condition filename 4 (y == spanY)");
+  parameter_handler.declare_entry("Use DIC linear interpolation","false",dealii::Patterns::Bool(),"Flag to linearly interpolate the DIC displacements between DIC points instead of using the nearest DIC point");
 
 
   parameter_handler.declare_entry("Enable cyclic loading","false",dealii::Patterns::Bool(),"Flag to indicate if cyclic loading is enabled");
@@ -504,6 +559,9 @@ void userInputParameters::declare_parameters(dealii::ParameterHandler & paramete
   parameter_handler.declare_entry("Skip Output Steps","-1",dealii::Patterns::Integer(),"Skip Output Steps");
   parameter_handler.declare_entry("Write Quadrature Output","false",dealii::Patterns::Bool(),"Flag to write quadrature output");
   parameter_handler.declare_entry("Skip Quadrature Output Steps","-1",dealii::Patterns::Integer(),"Skip Quadrature Output Steps");
+  parameter_handler.declare_entry("Write Grain Averaged Output","false",dealii::Patterns::Bool(),"Flag to write volume averaged stress, strain, slip, twin fraction and orientation per grain");
+  parameter_handler.declare_entry("Write memory report per increment","false",dealii::Patterns::Bool(),"Flag to print the per-processor memory consumption of the main data structures after every increment (the report is always printed at initialization and after the first increment)");
+  parameter_handler.declare_entry("Skip Grain Averaged Output Steps","-1",dealii::Patterns::Integer(),"Skip Grain Averaged Output Steps");
   parameter_handler.declare_entry("Output Equivalent strain","false",dealii::Patterns::Bool(),"Output Equivalent strain");
   parameter_handler.declare_entry("Output Equivalent stress","false",dealii::Patterns::Bool(),"Output Equivalent stress");
   parameter_handler.declare_entry("Output Grain ID","false",dealii::Patterns::Bool(),"Output Grain ID");
@@ -515,11 +573,25 @@ void userInputParameters::declare_parameters(dealii::ParameterHandler & paramete
   parameter_handler.declare_entry("Absolute nonLinear solver tolerance","-1",dealii::Patterns::Double(),"Non-linear solver tolerance");
   parameter_handler.declare_entry("Relative nonLinear solver tolerance","-1",dealii::Patterns::Double(),"Relative non-linear solver tolerance");
   parameter_handler.declare_entry("Stop on convergence failure","false",dealii::Patterns::Bool(),"Flag to stop problem if convergence fails");
+  parameter_handler.declare_entry("Enable nonlinear convergence check","false",dealii::Patterns::Bool(),"Flag to end the nonlinear iterations of an increment once the absolute or relative nonlinear solver tolerance is met. If false, the maximum number of nonlinear iterations is always performed. With this flag or adaptive time stepping, an increment which does not meet the tolerances after the maximum number of iterations is treated as not converged (cut back with adaptive time stepping)");
   parameter_handler.declare_entry("Enable adaptive Time stepping","false",dealii::Patterns::Bool(),"Flag to enable adaptive time steps");
   parameter_handler.declare_entry("Adaptive load step factor","-1",dealii::Patterns::Double(),"Load step factor");
   parameter_handler.declare_entry("Adaptive load increase Factor","-1",dealii::Patterns::Double(),"adaptive Load Increase Factor");
   parameter_handler.declare_entry("Succesive increment for increasing time step","-1",dealii::Patterns::Double(),"Succesive Inc For Increasing Time Step");
+  parameter_handler.declare_entry("Maximum number of increment cutbacks","10",dealii::Patterns::Integer(),"Maximum number of successive cutbacks of an increment with adaptive time stepping");
+  parameter_handler.declare_entry("Enable cost weighted repartitioning","false",dealii::Patterns::Bool(),"Flag to repartition the mesh using the measured constitutive cost of the cells as weights");
+  parameter_handler.declare_entry("Repartition interval","10",dealii::Patterns::Integer(),"Number of increments between repartitionings of the mesh");
+  parameter_handler.declare_entry("Number of threads per process","1",dealii::Patterns::Integer(),"Number of threads of each MPI process used by the thread-parallel cell loops (e.g. the cores of a NUMA domain). Only the post-processing loops (the projection of the post-processed fields, the averaging and history update after each increment, the reorientation and the assignment of the orientations) are threaded, the constitutive update and the assembly are serial");
+  parameter_handler.declare_entry("Enable adaptive refinement","false",dealii::Patterns::Bool(),"Flag to refine and coarsen the mesh during the simulation, with transfer of the history variables");
+  parameter_handler.declare_entry("Adaptive refinement interval","5",dealii::Patterns::Integer(),"Number of increments between mesh adaptations");
+  parameter_handler.declare_entry("Adaptive refinement indicator","plasticStrain",dealii::Patterns::Selection("plasticStrain|Kelly"),"Refinement indicator: mean plastic deformation of the cells or Kelly error estimate of the displacement");
+  parameter_handler.declare_entry("Adaptive refinement fraction","0.1",dealii::Patterns::Double(),"Fraction of the total indicator of the cells to be refined");
+  parameter_handler.declare_entry("Adaptive coarsening fraction","0.05",dealii::Patterns::Double(),"Fraction of the total indicator of the cells to be coarsened");
+  parameter_handler.declare_entry("Max adaptive refinement levels","2",dealii::Patterns::Integer(),"Maximum number of refinement levels above the initial mesh");
   parameter_handler.declare_entry("Enable the efficient calculation of stiffness","false",dealii::Patterns::Bool(),"Flag to enable the calculation of stiffness matrix only for the first iteration of each increment");
+  parameter_handler.declare_entry("Enable extrapolation predictor","false",dealii::Patterns::Bool(),"Flag to start each increment from the displacements extrapolated from the last two converged increments (suited for monotonic loading)");
+  parameter_handler.declare_entry("Enable inexact local tolerance","false",dealii::Patterns::Bool(),"Flag to loosen the material point tolerances in proportion to the relative residual of the nonlinear iterations (requires the nonlinear convergence check; the converged iteration always uses the strict tolerances)");
+  parameter_handler.declare_entry("Maximum local tolerance factor","100",dealii::Patterns::Double(),"Largest factor by which the material point tolerances are loosened");
 
 
 
@@ -581,8 +653,11 @@ void userInputParameters::declare_parameters(dealii::ParameterHandler & paramete
 
   parameter_handler.declare_entry("Stress Tolerance","-1",dealii::Patterns::Double(),"Stress tolerance for the yield surface (MPa)");
   parameter_handler.declare_entry("Max Slip Search Iterations","-1",dealii::Patterns::Integer(),"Maximum no. of active slip search iterations");
+  parameter_handler.declare_entry("Max Material Point Substeps","1",dealii::Patterns::Integer(),"Maximum no. of substeps of the material point increment if the constitutive update fails (1: no substepping). If all subdivisions fail, the increment is reset: it is cut back with adaptive time stepping, otherwise the run stops. Only the rate-independent model of calculatePlasticity.cc is substepped, the rate-dependent models in MaterialModels are not");
+  parameter_handler.declare_entry("Enable slip warm start","false",dealii::Patterns::Bool(),"Flag to start the active slip search from the active set and slip increments of the last solve at the material point. The FCC active set is not unique, so results can differ from the cold start. Only the rate-independent model of calculatePlasticity.cc is warm started, the Newton loops of the rate-dependent models in MaterialModels are not");
   parameter_handler.declare_entry("Max Solver Iterations","-1",dealii::Patterns::Integer(),"Maximum no. of iterations to achieve non-linear convergence");
   parameter_handler.declare_entry("Max Plastic Slip L2 Norm","-1",dealii::Patterns::Double(),"L2-Norm of plastic slip strain-used for load-step adaptivity");
+  parameter_handler.declare_entry("Single precision history fields","",dealii::Patterns::List(dealii::Patterns::Selection("orientation|slip resistance|backstress|twin fraction|state variables")),"History fields of the quadrature points stored in single precision (computations remain in double precision, Fp and Fe are always stored in double precision). Stored values are rounded to a relative accuracy of about 6e-8: orientation - Rodrigues vectors, rounding of about 1e-7 rad per increment; slip resistance - the yield condition at the start of an increment holds to about 1e-7 of the slip resistance instead of the Stress Tolerance, and hardening increments smaller than that per increment are lost; backstress - as slip resistance, relative to the backstress; twin fraction - twin volume fraction increments below about 6e-8 per increment are lost; state variables - relative rounding of the user material model state variables");
 
   parameter_handler.declare_entry("Grain ID file name","",dealii::Patterns::Anything(),"Grain ID file name");
   parameter_handler.declare_entry("Voxels in X direction","-1",dealii::Patterns::Integer(),"Number of voxels in x direction");
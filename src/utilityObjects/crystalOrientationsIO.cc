@@ -1,10 +1,44 @@
 #include "../../include/crystalOrientationsIO.h"
 
+namespace {
+  //allocate a table of the given size in a shared memory window of the node communicator.
+  //The memory is owned by the first process of the node and returned to all processes of the node.
+  template <typename T>
+  T* allocateNodeShared(std::size_t size, MPI_Comm nodeComm, unsigned int nodeRank, MPI_Win& window){
+    T* data;
+    const MPI_Aint localSize=(nodeRank==0) ? size*sizeof(T) : 0;
+    MPI_Win_allocate_shared(localSize, sizeof(T), MPI_INFO_NULL, nodeComm, &data, &window);
+    MPI_Aint ownerSize;
+    int dispUnit;
+    MPI_Win_shared_query(window, 0, &ownerSize, &dispUnit, &data);
+    return data;
+  }
+}
+
 //constructor
 template <int dim>
 crystalOrientationsIO<dim>::crystalOrientationsIO():
+voxelGrainIDsWindow(MPI_WIN_NULL),
+voxelGrainIDs(NULL),
+eulerAnglesWindow(MPI_WIN_NULL),
+eulerAngles(NULL),
+numEulerRows(0),
+numEulerColumns(0),
 pcout (std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0)
-{}
+{
+  //processes sharing the memory of a node
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD), MPI_INFO_NULL, &nodeComm);
+  nodeRank=dealii::Utilities::MPI::this_mpi_process(nodeComm);
+}
+
+//destructor
+template <int dim>
+crystalOrientationsIO<dim>::~crystalOrientationsIO()
+{
+  if (voxelGrainIDsWindow!=MPI_WIN_NULL) MPI_Win_free(&voxelGrainIDsWindow);
+  if (eulerAnglesWindow!=MPI_WIN_NULL) MPI_Win_free(&eulerAnglesWindow);
+  MPI_Comm_free(&nodeComm);
+}
 
   //loadOrientationVector reads the orientation euler angles file
   template <int dim>
@@ -15,47 +49,69 @@ pcout (std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0)
       exit(1);
     }
 
-    //open data file
-    std::ifstream eulerDataFile(_eulerFileName.c_str());
-    //read data
-    std::string line;
-    double value;
-    unsigned int id;
-    if (eulerDataFile.is_open()){
-      pcout << "reading orientation euler angles file\n";
-      //skip header lines
-      for (unsigned int i=0; i<1; i++) std::getline (eulerDataFile,line);
+    unsigned int counter=0;
+    if (_enableMultiphase){
+      counter=1;
+    }
+    unsigned int numberOfAdditionalVoxelInfo=_numVoxelData;
+    numEulerColumns=dim+counter+numberOfAdditionalVoxelInfo;
+
+    //the file is read by the first process of each node only
+    std::map<unsigned int, std::vector<double> > eulerAnglesRead;
+    unsigned int fileRead=1;
+    if (nodeRank==0){
+      //open data file
+      std::ifstream eulerDataFile(_eulerFileName.c_str());
       //read data
-      unsigned int counter=0;
-      if (_enableMultiphase){
-        counter=1;
-      }
-      unsigned int numberOfAdditionalVoxelInfo=_numVoxelData;
-      while (getline (eulerDataFile,line)){
-        std::stringstream ss(line);
-        unsigned int id;
-        ss >> id;
-        //double temp;
-        //ss >> temp;
-        eulerAngles[id]=std::vector<double>(dim+counter+numberOfAdditionalVoxelInfo);
-        ss >> eulerAngles[id][0];
-        ss >> eulerAngles[id][1];
-        ss >> eulerAngles[id][2];
-        if (_enableMultiphase){
-          ss >> eulerAngles[id][dim];
-        }
-        if (numberOfAdditionalVoxelInfo>0){
-          for (unsigned int j=0;j<numberOfAdditionalVoxelInfo;j++){
-            ss >> eulerAngles[id][dim+counter+j];
+      std::string line;
+      if (eulerDataFile.is_open()){
+        pcout << "reading orientation euler angles file\n";
+        //skip header lines
+        for (unsigned int i=0; i<1; i++) std::getline (eulerDataFile,line);
+        //read data
+        while (getline (eulerDataFile,line)){
+          std::stringstream ss(line);
+          unsigned int id;
+          ss >> id;
+          //double temp;
+          //ss >> temp;
+          eulerAnglesRead[id]=std::vector<double>(numEulerColumns);
+          ss >> eulerAnglesRead[id][0];
+          ss >> eulerAnglesRead[id][1];
+          ss >> eulerAnglesRead[id][2];
+          if (_enableMultiphase){
+            ss >> eulerAnglesRead[id][dim];
+          }
+          if (numberOfAdditionalVoxelInfo>0){
+            for (unsigned int j=0;j<numberOfAdditionalVoxelInfo;j++){
+              ss >> eulerAnglesRead[id][dim+counter+j];
+            }
           }
-        }
 
+        }
+        numEulerRows=(eulerAnglesRead.size()>0) ? eulerAnglesRead.rbegin()->first+1 : 0;
+      }
+      else{
+        fileRead=0;
       }
     }
-    else{
+    MPI_Bcast(&fileRead, 1, MPI_UNSIGNED, 0, nodeComm);
+    if (fileRead==0){
       pcout << "Unable to open eulerDataFile\n";
       exit(1);
     }
+
+    //table with one row per grain ID
+    MPI_Bcast(&numEulerRows, 1, MPI_UNSIGNED, 0, nodeComm);
+    if (eulerAnglesWindow!=MPI_WIN_NULL) MPI_Win_free(&eulerAnglesWindow);
+    eulerAngles=allocateNodeShared<double>((std::size_t)numEulerRows*numEulerColumns, nodeComm, nodeRank, eulerAnglesWindow);
+    if (nodeRank==0){
+      std::fill(eulerAngles, eulerAngles+(std::size_t)numEulerRows*numEulerColumns, 0.0);
+      for (std::map<unsigned int, std::vector<double> >::iterator it=eulerAnglesRead.begin(); it!=eulerAnglesRead.end(); ++it){
+        std::copy(it->second.begin(), it->second.end(), eulerAngles+(std::size_t)it->first*numEulerColumns);
+      }
+    }
+    MPI_Win_fence(0, eulerAnglesWindow);
   }
 
   //loadOrientations reads the voxel data file and orientations file
@@ -71,110 +127,105 @@ pcout (std::cout, dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0)
         exit(1);
       }
 
-      double _stencil[3]={_span[0]/(_numPts[0]), _span[1]/(_numPts[1]), _span[2]/(_numPts[2])}; // Dimensions of voxel
+      numVoxels=_numPts;
+      voxelSize.resize(3);
+      for (unsigned int i=0; i<3; i++) voxelSize[i]=_span[i]/(_numPts[i]); // Dimensions of voxel
 
-      //open voxel data file
-      std::ifstream voxelDataFile(_voxelFileName.c_str());
-      //read voxel data
-      std::string line;
-      double value;
-      unsigned int id;
-      if (voxelDataFile.is_open()){
-        pcout << "reading voxel data file\n";
-        //skip header lines
-        for (unsigned int i=0; i<headerLines; i++) std::getline (voxelDataFile,line);
-        //read data
-        for (unsigned int x=0; x<_numPts[0]; x++){
-          double xVal=x*_stencil[0]+_stencil[0]/2;
-          if (inputVoxelData.count(xVal)==0) inputVoxelData[xVal]=std::map<double, std::map<double, unsigned int> >();
-          for (unsigned int y=0; y<_numPts[1]; y++){
-            double yVal=y*_stencil[1]+_stencil[1]/2;
-            if (inputVoxelData[xVal].count(yVal)==0) inputVoxelData[xVal][yVal]=std::map<double, unsigned int>();
-            std::getline (voxelDataFile,line);
-            std::stringstream ss(line);
-            for (unsigned int z=0; z<_numPts[2]; z++){
-              double zVal=z*_stencil[2]+_stencil[2]/2;
-              ss >> inputVoxelData[xVal][yVal][zVal];
-              //pcout <<  inputVoxelData[xVal][yVal][zVal] << " ";
+      //grain IDs of the voxels in a flat table indexed by the voxel indices
+      const std::size_t totalNumVoxels=(std::size_t)_numPts[0]*_numPts[1]*_numPts[2];
+      if (voxelGrainIDsWindow!=MPI_WIN_NULL) MPI_Win_free(&voxelGrainIDsWindow);
+      voxelGrainIDs=allocateNodeShared<unsigned int>(totalNumVoxels, nodeComm, nodeRank, voxelGrainIDsWindow);
+
+      //the voxel data file is read by the first process of each node only
+      unsigned int fileRead=1;
+      if (nodeRank==0){
+        //open voxel data file
+        std::ifstream voxelDataFile(_voxelFileName.c_str());
+        //read voxel data
+        std::string line;
+        if (voxelDataFile.is_open()){
+          pcout << "reading voxel data file\n";
+          //skip header lines
+          for (unsigned int i=0; i<headerLines; i++) std::getline (voxelDataFile,line);
+          //read data
+          for (unsigned int x=0; x<_numPts[0]; x++){
+            for (unsigned int y=0; y<_numPts[1]; y++){
+              std::getline (voxelDataFile,line);
+              std::stringstream ss(line);
+              for (unsigned int z=0; z<_numPts[2]; z++){
+                ss >> voxelGrainIDs[((std::size_t)x*_numPts[1]+y)*_numPts[2]+z];
+              }
             }
-            //pcout << "\n";
           }
         }
+        else {
+          fileRead=0;
+        }
       }
-      else {
+      MPI_Win_fence(0, voxelGrainIDsWindow);
+      MPI_Bcast(&fileRead, 1, MPI_UNSIGNED, 0, nodeComm);
+      if (fileRead==0){
         pcout << "Unable to open file voxelDataFile\n";
         exit(1);
       }
+
+      char buffer[200];
+      sprintf(buffer, "voxel data stored once per node (%u processes per node)\n", dealii::Utilities::MPI::n_mpi_processes(nodeComm));
+      pcout << buffer;
     }
 
 //return materialID closest to given (x,y,z)
 template <int dim>
 unsigned int crystalOrientationsIO<dim>::getMaterialID(double _coords[]){
-  if (inputVoxelData.size()==0){
-     pcout << "inputVoxelData not initialized\n";
+  if (voxelGrainIDs==NULL){
+     pcout << "voxelGrainIDs not initialized\n";
      exit(1);
   }
-  
-  double dist_to_lower,dist_to_upper;
-  //find nearest point
-  //iterator to nearest x slice
-  std::map<double,std::map<double, std::map<double, unsigned int> > >::iterator itx;
-  std::map<double,std::map<double, std::map<double, unsigned int> > >::iterator itx_upper=inputVoxelData.lower_bound(_coords[0]);
-  std::map<double,std::map<double, std::map<double, unsigned int> > >::iterator itx_lower = itx_upper; itx_lower--;
-  if (itx_upper == inputVoxelData.end()) {
-    itx=itx_lower;
-  }
-  else{
-    dist_to_lower = std::abs(itx_lower->first - _coords[0]);
-    dist_to_upper = std::abs(itx_upper->first - _coords[0]);
-    if (dist_to_upper >= dist_to_lower) {
-      itx=itx_lower;
-    }
-    else {
-      itx=itx_upper;
-    }
-  }
-  if(itx == inputVoxelData.end()) --itx;
-
-  //iterator to nearest y slice
-  std::map<double, std::map<double, unsigned int> >::iterator ity;
-  std::map<double, std::map<double, unsigned int> >::iterator ity_upper=itx->second.lower_bound(_coords[1]);
-  std::map<double, std::map<double, unsigned int> >::iterator ity_lower=ity_upper; ity_lower--;
 
-  if (ity_upper == itx->second.end()) {
-    ity=ity_lower;
-  }
-  else{
-    dist_to_lower = std::abs(ity_lower->first - _coords[1]);
-    dist_to_upper = std::abs(ity_upper->first - _coords[1]);
-    if (dist_to_upper >= dist_to_lower) {
-      ity=ity_lower;
-    }
-    else {
-      ity=ity_upper;
+  //nearest voxel center (i+1/2)*voxelSize in each direction, ties go to the lower voxel
+  std::size_t index=0;
+  for (unsigned int d=0; d<3; d++){
+    const double h=voxelSize[d];
+    int lower=(int)std::floor(_coords[d]/h-0.5);
+    lower=std::max(0, std::min(lower, (int)numVoxels[d]-1));
+    unsigned int nearest=lower;
+    if (lower+1<(int)numVoxels[d]){
+      const double dist_to_lower=std::abs(lower*h+h/2-_coords[d]);
+      const double dist_to_upper=std::abs((lower+1)*h+h/2-_coords[d]);
+      if (dist_to_upper<dist_to_lower) nearest=lower+1;
     }
+    index=index*numVoxels[d]+nearest;
   }
+  return voxelGrainIDs[index];
+}
 
-  if(ity == itx->second.end()) --ity;
-  //iterator to nearest z slice
-  std::map<double, unsigned int>::iterator itz;
-  std::map<double, unsigned int>::iterator itz_upper=ity->second.lower_bound(_coords[2]);
-  std::map<double, unsigned int>::iterator itz_lower=itz_upper; itz_lower--;
-  if (itz_upper == ity->second.end()) {
-    itz=itz_lower;
+//return materialID of the voxel with the given (x,y,z) indices
+template <int dim>
+unsigned int crystalOrientationsIO<dim>::getVoxelMaterialID(unsigned int _voxelIndex[]){
+  if (voxelGrainIDs==NULL){
+     pcout << "voxelGrainIDs not initialized\n";
+     exit(1);
   }
-  else{
-    dist_to_lower = std::abs(itz_lower->first - _coords[2]);
-    dist_to_upper = std::abs(itz_upper->first - _coords[2]);
-    if (dist_to_upper >= dist_to_lower) {
-      itz=itz_lower;
-    }
-    else {
-      itz=itz_upper;
-    }
+  return voxelGrainIDs[((std::size_t)_voxelIndex[0]*numVoxels[1]+_voxelIndex[1])*numVoxels[2]+_voxelIndex[2]];
+}
+
+//return the row of the euler angles table of the given grain ID
+template <int dim>
+const double* crystalOrientationsIO<dim>::getEulerAngles(unsigned int _grainID){
+  if (_grainID>=numEulerRows){
+     pcout << "grain ID not found in the orientations file\n";
+     exit(1);
   }
-  if(itz == ity->second.end()) --itz;
-  return itz->second;
+  return eulerAngles+(std::size_t)_grainID*numEulerColumns;
+}
+
+//the node shared tables are counted for the first process of the node, which owns them
+template <int dim>
+std::size_t crystalOrientationsIO<dim>::memory_consumption() const{
+  if (nodeRank!=0) return 0;
+  std::size_t bytes=(std::size_t)numEulerRows*numEulerColumns*sizeof(double);
+  if (voxelGrainIDs!=NULL) bytes+=(std::size_t)numVoxels[0]*numVoxels[1]*numVoxels[2]*sizeof(unsigned int);
+  return bytes;
 }
 
     #include "../../include/crystalOrientationsIO_template_instantiations.h"
@@ -0,0 +1,78 @@
+#include "../../include/matrixExponential.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    //3x3 matrix product and inverse on fixed size tensors
+    Tensor<2,3,double> mmult3(const Tensor<2,3,double> &a, const Tensor<2,3,double> &b) {
+        Tensor<2,3,double> c;
+        for(unsigned int i=0;i<3;i++)
+        for(unsigned int j=0;j<3;j++)
+        c[i][j]=a[i][0]*b[0][j]+a[i][1]*b[1][j]+a[i][2]*b[2][j];
+        return c;
+    }
+
+    Tensor<2,3,double> invert3(const Tensor<2,3,double> &a) {
+        Tensor<2,3,double> c;
+        c[0][0]=a[1][1]*a[2][2]-a[1][2]*a[2][1]; c[0][1]=a[0][2]*a[2][1]-a[0][1]*a[2][2]; c[0][2]=a[0][1]*a[1][2]-a[0][2]*a[1][1];
+        c[1][0]=a[1][2]*a[2][0]-a[1][0]*a[2][2]; c[1][1]=a[0][0]*a[2][2]-a[0][2]*a[2][0]; c[1][2]=a[0][2]*a[1][0]-a[0][0]*a[1][2];
+        c[2][0]=a[1][0]*a[2][1]-a[1][1]*a[2][0]; c[2][1]=a[0][1]*a[2][0]-a[0][0]*a[2][1]; c[2][2]=a[0][0]*a[1][1]-a[0][1]*a[1][0];
+        const double det=a[0][0]*c[0][0]+a[0][1]*c[1][0]+a[0][2]*c[2][0];
+        return (1.0/det)*c;
+    }
+
+    //exp(A) and, if requested, its Gateaux derivative in the direction B, by scaling and squaring with
+    //the diagonal (6,6) Pade approximant. The derivative is the upper right block of the exponential of
+    //[[A,B],[0,A]], so every matrix of the exponential is carried with its derivative in the direction B.
+    void padeExponential(const Tensor<2,3,double> &A, const Tensor<2,3,double> &B, const bool derivative, Tensor<2,3,double> &expA, Tensor<2,3,double> &dExpA) {
+        const double c[7]={1.0, 1.0/2.0, 5.0/44.0, 1.0/66.0, 1.0/792.0, 1.0/15840.0, 1.0/665280.0};
+
+        //scaling: infinity norm of A/2^s below 1/2
+        double norm=0.0;
+        for(unsigned int i=0;i<3;i++) norm=std::max(norm,std::abs(A[i][0])+std::abs(A[i][1])+std::abs(A[i][2]));
+        int s=0;
+        if(norm>0.5) s=(int)std::ceil(std::log2(norm/0.5));
+        const double scale=std::ldexp(1.0,-s);
+        const Tensor<2,3,double> X=scale*A, Y=scale*B;
+
+        Tensor<2,3,double> I;
+        for(unsigned int i=0;i<3;i++) I[i][i]=1.0;
+
+        //even part V and odd part U=X*W of the numerator, the denominator is V-U
+        const Tensor<2,3,double> X2=mmult3(X,X), X4=mmult3(X2,X2), X6=mmult3(X4,X2);
+        const Tensor<2,3,double> V=c[0]*I+c[2]*X2+c[4]*X4+c[6]*X6;
+        const Tensor<2,3,double> W=c[1]*I+c[3]*X2+c[5]*X4;
+        const Tensor<2,3,double> U=mmult3(X,W);
+        const Tensor<2,3,double> Qinv=invert3(V-U);
+        Tensor<2,3,double> E=mmult3(Qinv,V+U), dE;
+
+        if(derivative){
+            const Tensor<2,3,double> dX2=mmult3(X,Y)+mmult3(Y,X);
+            const Tensor<2,3,double> dX4=mmult3(X2,dX2)+mmult3(dX2,X2);
+            const Tensor<2,3,double> dX6=mmult3(X4,dX2)+mmult3(dX4,X2);
+            const Tensor<2,3,double> dV=c[2]*dX2+c[4]*dX4+c[6]*dX6;
+            const Tensor<2,3,double> dU=mmult3(X,c[3]*dX2+c[5]*dX4)+mmult3(Y,W);
+            //d(Q^-1*P)=Q^-1*(dP-dQ*Q^-1*P)
+            dE=mmult3(Qinv,(dV+dU)-mmult3(dV-dU,E));
+        }
+
+        //squaring
+        for(int k=0;k<s;k++){
+            if(derivative) dE=mmult3(E,dE)+mmult3(dE,E);
+            E=mmult3(E,E);
+        }
+
+        expA=E;
+        dExpA=dE;
+    }
+}
+
+Tensor<2,3,double> matrixExponential3(const Tensor<2,3,double> &A) {
+    Tensor<2,3,double> expA, dExpA;
+    padeExponential(A,Tensor<2,3,double>(),false,expA,dExpA);
+    return expA;
+}
+
+void matrixExponentialAndGateauxDerivative3(const Tensor<2,3,double> &A, const Tensor<2,3,double> &B, Tensor<2,3,double> &expA, Tensor<2,3,double> &dExpA) {
+    padeExponential(A,B,true,expA,dExpA);
+}
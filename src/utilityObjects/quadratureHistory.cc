@@ -0,0 +1,67 @@
+#include "../../include/quadratureHistory.h"
+
+//constructor
+quadratureHistory::quadratureHistory():
+  numCells(0), numQuadPoints(0), numComponents(0), singlePrecision(false)
+{}
+
+void quadratureHistory::reinit(unsigned int _numCells, unsigned int _numQuadPoints, const Vector<double> &initial, bool _singlePrecision){
+  std::vector<double> values(initial.begin(), initial.end());
+  reinit(_numCells, _numQuadPoints, values, _singlePrecision);
+}
+
+void quadratureHistory::reinit(unsigned int _numCells, unsigned int _numQuadPoints, const std::vector<double> &initial, bool _singlePrecision){
+  numCells=_numCells; numQuadPoints=_numQuadPoints; numComponents=initial.size();
+  singlePrecision=_singlePrecision;
+  const std::size_t numPoints=std::size_t(numCells)*numQuadPoints;
+  doubleValues.clear(); floatValues.clear();
+  if (singlePrecision){
+    floatValues.resize(numPoints*numComponents);
+    for (std::size_t p=0; p<numPoints; p++)
+    for (unsigned int i=0; i<numComponents; i++) floatValues[p*numComponents+i]=initial[i];
+  }
+  else{
+    doubleValues.resize(numPoints*numComponents);
+    for (std::size_t p=0; p<numPoints; p++)
+    for (unsigned int i=0; i<numComponents; i++) doubleValues[p*numComponents+i]=initial[i];
+  }
+}
+
+void quadratureHistory::resize(unsigned int _numCells){
+  numCells=_numCells;
+  const std::size_t numValues=std::size_t(numCells)*numQuadPoints*numComponents;
+  if (singlePrecision) floatValues.resize(numValues,0.0);
+  else doubleValues.resize(numValues,0.0);
+}
+
+void quadratureHistory::copyCells(const quadratureHistory &source, unsigned int begin, unsigned int end){
+  const std::size_t cellSize=std::size_t(numQuadPoints)*numComponents;
+  end=std::min(end, std::min(numCells, source.numCells));
+  if (begin>=end) return;
+  if (singlePrecision)
+  std::copy(source.floatValues.begin()+begin*cellSize, source.floatValues.begin()+end*cellSize, floatValues.begin()+begin*cellSize);
+  else
+  std::copy(source.doubleValues.begin()+begin*cellSize, source.doubleValues.begin()+end*cellSize, doubleValues.begin()+begin*cellSize);
+}
+
+void quadratureHistory::get(unsigned int cellID, unsigned int quadPtID, Vector<double> &values) const{
+  values.reinit(numComponents);
+  for (unsigned int i=0; i<numComponents; i++) values(i)=(*this)(cellID, quadPtID, i);
+}
+
+void quadratureHistory::get(unsigned int cellID, unsigned int quadPtID, std::vector<double> &values) const{
+  values.resize(numComponents);
+  for (unsigned int i=0; i<numComponents; i++) values[i]=(*this)(cellID, quadPtID, i);
+}
+
+void quadratureHistory::set(unsigned int cellID, unsigned int quadPtID, const Vector<double> &values){
+  for (unsigned int i=0; i<numComponents; i++) set(cellID, quadPtID, i, values(i));
+}
+
+void quadratureHistory::set(unsigned int cellID, unsigned int quadPtID, const std::vector<double> &values){
+  for (unsigned int i=0; i<numComponents; i++) set(cellID, quadPtID, i, values[i]);
+}
+
+std::size_t quadratureHistory::memory_consumption() const{
+  return doubleValues.capacity()*sizeof(double)+floatValues.capacity()*sizeof(float);
+}
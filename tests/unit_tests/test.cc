@@ -0,0 +1,59 @@
+//unit test of the 3x3 matrix exponential and its Gateaux derivative (src/utilityObjects/matrixExponential.cc):
+//the exponential is compared with its Taylor series and the derivative with central differences
+//of the exponential, for random matrices with norms from 0.01 to 5
+#include "../../include/matrixExponential.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+namespace {
+  Tensor<2,3,double> taylorExponential(const Tensor<2,3,double> &A){
+    Tensor<2,3,double> expA, term;
+    for (unsigned int i=0; i<3; i++) term[i][i]=1.0;
+    expA=term;
+    for (unsigned int k=1; k<200; k++){
+      term=(1.0/k)*(term*A);
+      expA+=term;
+      if (term.norm()<1.0e-18*expA.norm()) break;
+    }
+    return expA;
+  }
+
+  Tensor<2,3,double> randomTensor(const double norm){
+    Tensor<2,3,double> A;
+    for (unsigned int i=0; i<3; i++)
+    for (unsigned int j=0; j<3; j++) A[i][j]=2.0*std::rand()/RAND_MAX-1.0;
+    return (norm/A.norm())*A;
+  }
+}
+
+int main(){
+  std::srand(1);
+  const double norms[6]={0.01, 0.1, 0.5, 1.0, 2.0, 5.0};
+  double maxExpError=0.0, maxDerivativeError=0.0;
+
+  for (unsigned int n=0; n<6; n++){
+    for (unsigned int sample=0; sample<100; sample++){
+      const Tensor<2,3,double> A=randomTensor(norms[n]), B=randomTensor(1.0);
+      const Tensor<2,3,double> expA=matrixExponential3(A);
+      maxExpError=std::max(maxExpError, (expA-taylorExponential(A)).norm()/expA.norm());
+
+      Tensor<2,3,double> expA2, dExpA;
+      matrixExponentialAndGateauxDerivative3(A, B, expA2, dExpA);
+      const double h=1.0e-5;
+      const Tensor<2,3,double> dExpAFD=(0.5/h)*(matrixExponential3(A+h*B)-matrixExponential3(A-h*B));
+      maxDerivativeError=std::max(maxDerivativeError, (dExpA-dExpAFD).norm()/dExpA.norm());
+      maxExpError=std::max(maxExpError, (expA2-expA).norm()/expA.norm());
+    }
+  }
+
+  printf("matrix exponential: max relative error %e (Taylor series)\n", maxExpError);
+  printf("Gateaux derivative: max relative error %e (central differences)\n", maxDerivativeError);
+  if ((maxExpError<1.0e-12)&&(maxDerivativeError<1.0e-7)){
+    printf("passed\n");
+    return 0;
+  }
+  printf("failed\n");
+  return 1;
+}